@@ -5,8 +5,12 @@
 
 std::ostream & operator<<(std::ostream & out, const CNFClauses & cnf)
 {
-    FOR (CNFClause const & clause, cnf)
-        out << clause;
+    for (CNFClauses::size_type i = 0; i < cnf.size(); ++i)
+    {
+        FOR (Literal const lit, cnf[i])
+            out << lit << ' ';
+        out << std::endl;
+    }
     return out;
 }
 
@@ -18,30 +22,26 @@ void CNFClauses::append
     (CNFClauses const & cnf, Atom const natoms,
      Literal const arglist[], Atom const nargs)
 {
-    size_type const oldsize = size();
-    resize(oldsize + cnf.size());
+    m_literals.reserve(m_literals.size() + cnf.m_literals.size());
     // New clauses
     for (size_type i = 0; i < cnf.size(); ++i)
     {
-        (*this)[oldsize + i].resize(cnf[i].size());
-        for (CNFClause::size_type j = 0; j < cnf[i].size(); ++j)
-        {
-            Literal const lit = cnf[i][j];
-            (*this)[oldsize + i][j] = lit / 2 < nargs ?
-            arglist[lit / 2] ^ (lit & 1) : lit + (natoms - nargs) * 2;
-        }
+        FOR (Literal const lit, cnf[i])
+            addliteral(lit / 2 < nargs ?
+            arglist[lit / 2] ^ (lit & 1) : lit + (natoms - nargs) * 2);
+        m_ends.push_back(m_literals.size());
     }
 }
 
 // Check the satisfaction of clause under the model.
 // If UNIT, return (UNIT, index of unassigned literal).
 // If UNDECIDED, return (UNDECIDED, index of unassigned literal).
-std::pair<CNFClausesat, CNFClause::size_type> CNFclausesat
-        (CNFClause const & clause, CNFModel const & model)
+std::pair<CNFClausesat, CNFClauseview::size_type> CNFclausesat
+        (CNFClauseview clause, CNFModel const & model)
 {
     bool nonefound = false;
     Atom oldatom = 0;
-    CNFClause::size_type unitindex = 0;
+    CNFClauseview::size_type unitindex = 0;
 
     FOR (Literal const & lit, clause)
     {
@@ -53,7 +53,7 @@ std::pair<CNFClausesat, CNFClause::size_type> CNFclausesat
                 return std::make_pair(UNDECIDED, unitindex);
             nonefound = true;
             oldatom = lit / 2;
-            unitindex = &lit - clause.data();
+            unitindex = &lit - clause.begin();
             continue;
         case TRUE:
             return std::make_pair(SATISFIED, 0u);
@@ -85,8 +85,7 @@ static bool checkmask
 static void addclausefromindexmask
     (Atom natoms, TTindex index, bool value, Mask mask, CNFClauses & cnf)
 {
-    cnf.resize(cnf.size() + 1);
-    CNFClause & clause = cnf.back();
+    CNFClause clause;
 
     for (Atom i = 0; i < natoms; ++i)
     {
@@ -100,6 +99,7 @@ static void addclausefromindexmask
 
     // Add positive lit if value is true, negative lit if false
     clause.push_back(natoms * 2 + (value ^ 1));
+    cnf.push_back(clause);
 }
 
 // Return a clause covering tt[index], and update processed.
@@ -149,7 +149,7 @@ static void processttentry
 }
 
 // Construct the cnf representing a truth table.
-CNFClauses::CNFClauses(Bvector const & truthtable)
+CNFClauses::CNFClauses(Bvector const & truthtable) : m_natoms(1)
 {
     Bvector processed(truthtable.size(), false);
     Bvector::iterator const begin(processed.begin());
@@ -1,21 +1,36 @@
 #ifndef CNF_H_INCLUDED
 #define CNF_H_INCLUDED
 
-#include <algorithm>// for std::max and std::max_element
+#include <algorithm>// for std::max
 #include <cstddef>  // for std::size_t
 #include <vector>
 #include "util/for.h"
-#include "util/filter.h"
 #include "util/tribool.h"
 
 // Atom: P = 0, Q = 1, ... Literal: P = 0, !P = 1, Q = 2, !Q = 3, ...
-typedef std::size_t Atom, Literal;
+typedef unsigned Atom, Literal;
 // Boolean vector
 typedef std::vector<bool> Bvector;
 typedef Bvector::size_type TTindex;
 // A list of literals
 typedef std::vector<Literal> CNFClause;
 
+// View of the literals of a clause stored elsewhere
+struct CNFClauseview
+{
+    typedef Literal const * const_iterator;
+    typedef std::size_t size_type;
+    CNFClauseview(const_iterator begin, const_iterator end) :
+        m_begin(begin), m_end(end) {}
+    const_iterator begin() const { return m_begin; }
+    const_iterator end() const { return m_end; }
+    size_type size() const { return m_end - m_begin; }
+    bool empty() const { return m_begin == m_end; }
+    Literal operator[](size_type i) const { return m_begin[i]; }
+private:
+    const_iterator m_begin, m_end;
+};
+
 // Satisfaction of a clause
 enum CNFClausesat{UNDECIDED = -2, UNIT = -1, CONTRADICTORY = 0, SATISFIED = 1};
 
@@ -37,28 +52,65 @@ struct CNFModel : public std::vector<int>
 // Check the satisfaction of clause under the model.
 // If UNIT, return (UNIT, index of unassigned literal).
 // If UNDECIDED, return (UNDECIDED, index of unassigned literal).
-std::pair<CNFClausesat, CNFClause::size_type> CNFclausesat
-        (CNFClause const & clause, CNFModel const & model);
+std::pair<CNFClausesat, CNFClauseview::size_type> CNFclausesat
+        (CNFClauseview clause, CNFModel const & model);
 
-// Instance in conjunctive normal form
-struct CNFClauses : public std::vector<CNFClause>
+struct CNFClauses;
+
+// View of the clauses [first, last) of an instance
+struct CNFSlice
 {
-    CNFClauses(size_type n = 0) : std::vector<CNFClause>(n) {}
+    CNFClauses const * cnf;
+    std::size_t first, last;
+    // # clauses
+    std::size_t size() const { return last - first; }
+    bool empty() const { return first == last; }
+    // Clause i of the slice
+    CNFClauseview operator[](std::size_t i) const;
+    bool hasemptyclause() const;
+    // Return # atoms in the whole instance. Return 1 for empty instance.
+    Atom natoms() const;
+};
+// List of slices, whose clauses are taken together
+typedef std::vector<CNFSlice> CNFSlices;
+
+// Instance in conjunctive normal form.
+// The literals of all clauses are kept back to back.
+struct CNFClauses
+{
+    typedef std::vector<Literal>::size_type size_type;
+    CNFClauses() : m_natoms(1) {}
     // Construct the cnf representing a truth table.
     CNFClauses(Bvector const & truthtable);
-    bool hasemptyclause() const { return util::filter(*this)(CNFClause()); }
+    // # clauses
+    size_type size() const { return m_ends.size(); }
+    bool empty() const { return m_ends.empty(); }
+    // Clause i
+    CNFClauseview operator[](size_type i) const
+    {
+        Literal const * const data = m_literals.data();
+        return CNFClauseview(data + (i ? m_ends[i - 1] : 0), data + m_ends[i]);
+    }
+    // View of clauses [first, last)
+    CNFSlice slice(size_type first, size_type last) const
+    {
+        CNFSlice const result = {this, first, last};
+        return result;
+    }
+    // View of all clauses
+    CNFSlice slice() const { return slice(0, size()); }
+    bool hasemptyclause() const { return slice().hasemptyclause(); }
     // Return # atoms in cnf. Return 1 for empty instance.
-    Atom natoms() const
+    Atom natoms() const { return m_natoms; }
+    void clear() { m_literals.clear(); m_ends.clear(); m_natoms = 1; }
+    // Add a clause.
+    void push_back(CNFClause const & clause)
+    { push_back(clause.data(), clause.data() + clause.size()); }
+    void push_back(Literal const * begin, Literal const * end)
     {
-        // Maximal literal
-        Literal max = 0;
-        FOR (const_reference clause, *this)
-        {
-            if (clause.empty()) continue;
-            max = std::max(max,*std::max_element(clause.begin(),clause.end()));
-        }
-        // Maximal atom + 1
-        return max / 2 + 1;
+        for ( ; begin != end; ++begin)
+            addliteral(*begin);
+        m_ends.push_back(m_literals.size());
     }
     // Append cnf to the end.
     // If atom < nargs, change it to arglist[atom], with sense adjusted.
@@ -67,29 +119,53 @@ struct CNFClauses : public std::vector<CNFClause>
     void append
         (CNFClauses const & cnf, Atom const natoms,
          Literal const arglist[], Atom const nargs);
-    // Add a clause containing a single literal. Return *this.
+    // Add a clause containing a single literal.
     void closeoff(Atom const atom, bool const neg = false)
-    { push_back(CNFClause(1, atom * 2 + neg)); }
-    // Add a clause containing the next atom alone or its neg. Return *this.
-    void closeoff(bool const neg = false)
-    { closeoff(natoms() - 1, neg); }
-    // Return true if there is no contradiction in the model so far.
-    bool okaysofar(CNFModel const & model) const
     {
-        FOR (const_reference clause, *this)
-            if (CNFclausesat(clause, model).first == CONTRADICTORY)
-                return false;
-        return true;
+        addliteral(atom * 2 + neg);
+        m_ends.push_back(m_literals.size());
     }
+    // Add a clause containing the next atom alone or its neg.
+    void closeoff(bool const neg = false)
+    { closeoff(natoms() - 1, neg); }
     // Return true if the SAT instance and the conclusion are satisfiable.
     bool sat(CNFClauses const & conclusion = CNFClauses()) const;
     // Return if the clauses are satisfiable.
     // Map: free atoms -> truth value.
     // Return the empty vector if unsuccessful.
     Bvector truthtable(Atom const nfree) const;
+private:
+    // Literals of all clauses, back to back
+    std::vector<Literal> m_literals;
+    // m_ends[i] = end of clause i in m_literals
+    std::vector<size_type> m_ends;
+    // Maximal atom + 1, kept as the instance grows
+    Atom m_natoms;
+    // Add a literal to the last clause, which is open.
+    void addliteral(Literal const lit)
+    {
+        m_literals.push_back(lit);
+        m_natoms = std::max(m_natoms, lit / 2 + 1);
+    }
 };
 
+inline CNFClauseview CNFSlice::operator[](std::size_t i) const
+{ return (*cnf)[first + i]; }
+
+inline bool CNFSlice::hasemptyclause() const
+{
+    for (std::size_t i = 0; i < size(); ++i)
+        if ((*this)[i].empty())
+            return true;
+    return false;
+}
+
+inline Atom CNFSlice::natoms() const { return cnf->natoms(); }
+
+// Return true if the clauses of all slices together are satisfiable.
+bool satisfiable(CNFSlices const & slices);
+
 // Pair (CNF, # clauses corresponding to hypotheses)
 typedef std::pair<CNFClauses, std::vector<CNFClauses::size_type> > HypsCNF;
 
-#endif // SAT_H_INCLUDED
\ No newline at end of file
+#endif // CNF_H_INCLUDED
@@ -3,6 +3,7 @@
 
 #include <algorithm>// for std::upper_bound
 #include "types.h"
+#include "util/for.h"
 
 // Hypothesis label delimiter
 static const std::string hypdelim = "~";
@@ -18,6 +19,8 @@ struct Assertion
     Disjvars disjvars;
     // Statement of axiom or theorem
     Expression expression;
+    // Codes of the symbols of the statement
+    Symbolcodes codes;
     // # of axiom or theorem as ordered in the input file, starting from 1
     nAss number;
     // Position in tokens
@@ -35,6 +38,8 @@ struct Assertion
     RPN expRPN, proof;
     // Abstract syntax tree of expression
     AST expAST;
+    // Compiled matcher of expression
+    Matcher expmatcher;
     // All maximal spans of the expression governed by a syntax axiom.
     GovernedRPNspansbystep expmaxabs;
     // Type (propositional, predicate, etc)
@@ -68,6 +73,9 @@ struct Assertion
     AST const & hypAST(Hypsize index) const { return hyp(index).ast; }
     RPNspanAST hypRPNAST(Hypsize index) const
         { return RPNspanAST(hypRPN(index), hypAST(index)); }
+    // Compiled matcher of a hypothesis
+    Matcher const & hypmatcher(Hypsize index) const
+        { return hyp(index).matcher; }
     // Length of a hypothesis
     RPNsize hyplen(Hypsize index) const { return hypRPN(index).size(); }
     // Total length of RPNs of hypotheses
@@ -143,4 +151,61 @@ struct Assertion
     unsigned settype(unsigned mask) { return type |= mask; }
 };
 
+// Map: assertion label -> T, also indexed by # of the assertion,
+// so that proof steps find their entries without comparing labels
+template<class T>
+struct Assmap : std::map<strview, T>
+{
+    typedef std::map<strview, T> Map;
+    typedef typename Map::const_pointer const_pointer;
+    Assmap() {}
+    // Copies index their own entries.
+    Assmap(Assmap const & other) : Map(other) { reindex(other); }
+    Assmap & operator=(Assmap const & other)
+    {
+        if (this != &other)
+            Map::operator=(other), reindex(other);
+        return *this;
+    }
+    // Index the entries by # of assertion. Call after adding all entries.
+    void index(Assertions const & assertions)
+    {
+        m_index.clear();
+        FOR (typename Map::const_reference entry, *this)
+        {
+            Assiter const iter = assertions.find(entry.first);
+            if (iter == assertions.end())
+                continue;
+            nAss const number = iter->second.number;
+            if (number >= m_index.size())
+                m_index.resize(number + 1);
+            m_index[number] = &entry;
+        }
+    }
+    // Return the entry of an assertion. Return NULL if none.
+    const_pointer findass(pAss pass) const
+    {
+        if (!pass || pass->second.number >= m_index.size())
+            return NULL;
+        const_pointer const entry = m_index[pass->second.number];
+        // Assertions made in the search reuse the # of the problem.
+        return entry && entry->first == pass->first ? entry : NULL;
+    }
+private:
+    // m_index[# of assertion] = its entry, NULL if none
+    std::vector<const_pointer> m_index;
+    // Point the index to the entries matching those of other.
+    void reindex(Assmap const & other)
+    {
+        std::map<const_pointer, const_pointer> entries;
+        typename Map::const_iterator iter = this->begin();
+        FOR (typename Map::const_reference entry, other)
+            entries[&entry] = &*iter++;
+        m_index.assign(other.m_index.size(), NULL);
+        for (nAss i = 0; i < m_index.size(); ++i)
+            if (other.m_index[i])
+                m_index[i] = entries[other.m_index[i]];
+    }
+};
+
 #endif // ASS_H_INCLUDED
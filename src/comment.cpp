@@ -1,7 +1,6 @@
-#include <numeric>  // for std::accumulate
-#include <fstream>
+#include <algorithm>    // for std::find
+#include <numeric>      // for std::accumulate
 #include <iostream>
-#include <sstream>
 #include <vector>
 #include "comment.h"
 #include "io.h"
@@ -33,67 +32,55 @@ static void commenterr(const char * badstring, std::string const & comment)
     std::cerr << comment << std::endl;
 }
 
-// Read and return a comment. Return "" on failure ($4.1.2).
-std::string comment(std::ifstream & in)
+// Read a comment starting at pos, after "$(", and advance pos past "$)".
+// Return the text of the comment, null-terminated in place.
+// Return NULL on failure ($4.1.2).
+const char * comment(char * & pos, char * const end)
 {
-    std::stringstream out;//("", std::ios_base::ate);
+    char * const begin = pos;
 
-    while (in.good())
+    while (true)
     {
-        // Read up to '$'. Skip if the next char is '$'. Otherwise in fails.
-        in.get(*out.rdbuf(), '$');
-
-        // Eat '$' in the stream.
-        if (in.eof() || in.bad() || (in.clear(), in.get(), !in.good()))
+        // Read up to '$'.
+        char * const dollar = std::find(pos, end, '$');
+        if (dollar == end || dollar + 1 == end)
         {
-            std::cerr << "Unclosed comment" << out.str() << std::endl;
-            return "";
+            std::cerr << "Unclosed comment" << std::string(begin, end);
+            std::cerr << std::endl;
+            return NULL;
         }
 
         // Check if the token is legal.
-        char c(in.get());
+        pos = dollar + 2;
+        char const c = dollar[1];
         if (c == '(')
         {
-            commenterr("$(", out.str());
-            return "";
+            commenterr("$(", std::string(begin, dollar));
+            return NULL;
         }
 
         if (c == ')')
         {
-            // the last char read
-            char last = 0;
-            out.seekg(-1, std::ios::end);
-            out >> last;
-
-            if (std::strchr(mmws, last) == NULL)
+            // The token begins with "$)". Check if it begins a token.
+            if (dollar > begin && std::strchr(mmws, dollar[-1]) == NULL)
             {
-                commenterr("...$)", out.str());
-                return "";
+                commenterr("...$)", std::string(begin, dollar));
+                return NULL;
             }
 
-            // The token begins with "$)". Check if it ends here.
-            if (in.eof())
-                return out.str();
-            if (!in.good())
-                return "";
-
-            // the next char to read
-            if (std::strchr(mmws, in.peek()) == NULL)
+            // Check if it ends here.
+            if (pos != end && std::strchr(mmws, *pos) == NULL)
             {
-                commenterr("$)...", out.str());
-                return "";
+                commenterr("$)...", std::string(begin, dollar));
+                return NULL;
             }
 
             // "$)" is legal.
-            return out.str();
+            *dollar = '\0';
+            return begin;
         }
-
         // "$" followed by other chars
-        out.seekg(0, std::ios::end);
-        out << '$' << c;
     }
-
-    return "";
 }
 
 // Read commands from comments ($4.4.2 and 4.4.3). C-comment unsupported.
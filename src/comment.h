@@ -10,7 +10,7 @@ const char mmws[] = "\t\n\f\r "; // metamath whitespace chars ($4.1.1)
 
 struct Comment
 {
-    std::string text;
+    strview text;
     Tokens::size_type tokenpos;
     operator Tokens::size_type() const { return tokenpos; }
 };
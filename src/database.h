@@ -10,6 +10,7 @@
 #include "syntaxiom.h"
 #include "thmpool.h"
 #include "util/for.h"
+#include "util/intern.h"
 // #include "io.h"
 class Database
 {
@@ -20,7 +21,14 @@ class Database
     Hypotheses m_hypotheses;
     Assertions m_assertions;
     Assiters m_assiters;
+    // Table of the tokens read, whose IDs index the labels below
+    util::Interner m_symbols;
+    // m_hypsbyid[ID of label] = iterator to the hypothesis, Hypiter() if none
+    std::vector<Hypiter> m_hypsbyid;
+    // m_assbyid[ID of label] = pointer to the assertion, NULL if none
+    std::vector<pAss> m_assbyid;
     Theorempools m_theorempools;
+    Absindex m_absindex;
     SyntaxDAG m_syntaxDAG;
     Syntaxioms m_syntaxioms;
     Commentinfo m_commentinfo;
@@ -29,8 +37,10 @@ class Database
     Info m_info;
 public:
     Database() : m_assiters(1) { addvar(""); }
+    // Read data from tokens. Returns true if okay.
+    // Proofs are not verified if verifyproofs is false.
     bool read(Tokens & tokens, Comments const & comments,
-              Tokens::size_type upto);
+              Tokens::size_type upto, bool verifyproofs = true);
     void clear() { *this = Database(); }
     Symbol2::ID varid(strview str) const { return varIDmap().at(str); }
     VarIDmap const & varIDmap() const { return m_varIDmap; }
@@ -38,6 +48,7 @@ public:
     Assertions const & assertions() const { return m_assertions; }
     Assiters const & assiters() const { return m_assiters; }
     Theorempools const & theorempools() const { return m_theorempools; }
+    Absindex const & absindex() const { return m_absindex; }
     SyntaxDAG const & syntaxDAG() const { return m_syntaxDAG; }
     Syntaxioms const & syntaxioms() const { return m_syntaxioms; }
     Syntaxioms primitivesyntaxioms() const
@@ -46,6 +57,7 @@ public:
         FOR (Syntaxioms::const_reference axiom, syntaxioms())
             if (!definitions().count(axiom.first))
                 axioms.insert(axiom);
+        axioms.index(assertions());
         return axioms;
     }
     Commentinfo const & commentinfo() const { return m_commentinfo; }
@@ -91,7 +103,13 @@ public:
     bool hasvar(strview str) const { return varIDmap().count(str); }
     void addvar(strview str)
     { m_varIDmap.insert(std::make_pair(str, varIDmap().size())); }
-    bool hashyp(strview label) const { return hypotheses().count(label); }
+    // Return the hypothesis with a label. Return Hypiter() if none.
+    Hypiter findhyp(strview label) const
+    {
+        util::Interner::ID const id = m_symbols.id(label);
+        return id < m_hypsbyid.size() ? m_hypsbyid[id] : Hypiter();
+    }
+    bool hashyp(strview label) const { return findhyp(label) != Hypiter(); }
     Hypiter addhyp(strview label, Expression const & exp, bool const floating)
     {
         Hypotheses::value_type value(label, Hypothesis(Expression(), floating));
@@ -100,9 +118,28 @@ public:
         hypexp = exp;
         if (floating) // Point the defined variable to the hypothesis
             hypexp[1].iter = iter;
+        iter->second.codes = codes(hypexp);
+        util::Interner::ID const id = m_symbols.add(label);
+        if (id >= m_hypsbyid.size())
+            m_hypsbyid.resize(id + 1);
+        m_hypsbyid[id] = iter;
         return iter;
     }
-    bool hasass(strview label) const { return assertions().count(label); }
+    // Return the codes of the symbols of an expression read.
+    Symbolcodes codes(Expression const & exp) const
+    {
+        Symbolcodes result(exp.size());
+        for (Expression::size_type i = 0; i < exp.size(); ++i)
+            result[i] = m_symbols.id(exp[i]);
+        return result;
+    }
+    // Return the assertion with a label. Return NULL if none.
+    pAss findass(strview label) const
+    {
+        util::Interner::ID const id = m_symbols.id(label);
+        return id < m_assbyid.size() ? m_assbyid[id] : NULL;
+    }
+    bool hasass(strview label) const { return findass(label); }
     // Construct an Assertion from an Expression. That is, determine the
     // mandatory hypotheses and disjoint variable restrictions and the #.
     // The Assertion is inserted into the assertions collection.
@@ -136,12 +173,18 @@ public:
         m_syntaxioms = Syntaxioms(assertions(), *this);
         if (!syntaxioms().addRPN(m_assertions, typecodes()))
             return false;
-
+        addrelations();
+        return true;
+    }
+// Classify the relations among assertions.
+    void addrelations()
+    {
         Relations relations(assertions());
         FOR (Relations::const_reference relation, relations)
             m_relations[relation.second.type()].insert(relation);
-        return true;
     }
+// Add the revPolish notation saved in a snapshot. Return true if okay.
+    bool addRPN(struct Snapshot const & snapshot);
 // Test syntax parser. Return true if okay.
     bool checkRPN() const;
     void addtheorempool()
@@ -149,6 +192,22 @@ public:
         Theorempools usabletheorems
             (Assiters const & assiters, struct Typecodes const & typecodes);
         m_theorempools = usabletheorems(assiters(), typecodes());
+        // Compile matchers of conclusions and hypotheses.
+        FOR (Assertions::reference rass, m_assertions)
+            rass.second.expmatcher = matcher(rass.second.expRPN);
+        FOR (Hypotheses::reference rhyp, m_hypotheses)
+            rhyp.second.matcher = matcher(rhyp.second.rpn);
+        // Index spans governed by syntax axioms in conclusions.
+        m_absindex.clear();
+        for (nAss i = 1; i < assiters().size(); ++i)
+        {
+            Assertion const & ass = assiters()[i]->second;
+            if (ass.nEhyps() > 0)
+                continue; // Not usable as a conjecture
+            FOR (GovernedRPNspansbystep::const_reference rstep, ass.expmaxabs)
+                m_absindex[rstep.first].push_back
+                (Absentry(&*assiters()[i], &rstep.second));
+        }
     }
 // Find definitions in assertions.
     void loaddefinitions()
@@ -154,6 +154,7 @@ Definitions::Definitions
         std::cout << sa << "\tredefined by " << df << std::endl;
         adddef(*newiter, typecodes, equalities);
     }
+    index(assertions);
 }
 
 // Add a definition. Return true if okay.
@@ -31,7 +31,7 @@ struct Definition
 };
 
 // Map: label of syntax axiom -> its definition
-struct Definitions : std::map<strview, Definition>
+struct Definitions : Assmap<Definition>
 {
     Definitions() {}
     Definitions
@@ -1,5 +1,7 @@
+#include "disjvars.h"
 #include "io.h"
 #include "types.h"
+#include "util/bits.h"
 #include "util/filter.h"// for is_disjoint
 #include "util/for.h"
 
@@ -13,9 +15,9 @@ std::ostream & operator<<(std::ostream & out, Disjvars const & disjvars)
 // Print disjoint variable hypothesis violation error.
 void printDVerr(Expression const & exp1, Expression const & exp2)
 {
-    std::cerr << "Expression\n" << exp1 << "and ";
-    std::cerr << "Expression\n" << exp2;
-    std::cerr << "violate the disjoint variable hypothesis" << std::endl;
+    errs() << "Expression\n" << exp1 << "and ";
+    errs() << "Expression\n" << exp2;
+    errs() << "violate the disjoint variable hypothesis" << std::endl;
 }
 
 // Restrict disjoint variables hypotheses to a set of variables.
@@ -28,6 +30,60 @@ Disjvars operator &(Disjvars const & disjvars, Varusage const & varusage)
     return result;
 }
 
+DVmatrix::DVmatrix(Disjvars const & DV, Varusage const & varusage) :
+    m_rows(varusage.size(),
+           Varmask(util::nwords<std::size_t>(varusage.size())))
+{
+    std::size_t n = 0;
+    FOR (Varusage::const_reference var, varusage)
+    {
+        if (var.first.id >= m_index.size())
+            m_index.resize(var.first.id + 1);
+        m_index[var.first.id] = ++n;
+    }
+    FOR (Disjvars::const_reference vars, DV)
+    {
+        std::size_t const i = index(vars.first.id), j = index(vars.second.id);
+        if (i == 0 || j == 0 || i == j)
+            continue;
+        util::setbit(m_rows[i - 1], j - 1);
+        util::setbit(m_rows[j - 1], i - 1);
+    }
+}
+
+// Mask of the variables in an RPN.
+// Return false if it has a variable not in the statement.
+bool DVmatrix::mask(RPN const & rpn, Varmask & result) const
+{
+    clear(result);
+    FOR (RPNstep step, rpn)
+        if (Symbol2::ID const id = step.id())
+            if (!add(id, result))
+                return false;
+    return true;
+}
+
+// Add a variable to a mask. Return false if it is not in the statement.
+bool DVmatrix::add(Symbol2::ID id, Varmask & mask) const
+{
+    std::size_t const i = index(id);
+    if (i == 0)
+        return false;
+    util::setbit(mask, i - 1);
+    return true;
+}
+
+// Return true if variables in two masks are disjoint and
+// satisfy the disjoint variable hypotheses.
+bool DVmatrix::check(Varmask const & x, Varmask const & y) const
+{
+    // No variable is disjoint from itself, so a common one fails too.
+    for (std::vector<Varmask>::size_type i = 0; i < m_rows.size(); ++i)
+        if (util::testbit(x, i) && !util::issubset(y, m_rows[i]))
+            return false;
+    return true;
+}
+
 // Return true if two variables satisfy the disjoint variable hypothesis.
 static bool checkDV
     (strview var1, strview var2, Disjvars const & DV)
@@ -49,8 +105,8 @@ static bool checkDV
             {
                 if (verbose)
                 {
-                    std::cerr << var1 << " and " << var2;
-                    std::cerr << " violate the disjoint variable hypothesis\n";
+                    errs() << var1 << " and " << var2;
+                    errs() << " violate the disjoint variable hypothesis\n";
                 }
                 return false;
             }
@@ -71,13 +127,13 @@ static bool operator<(Varusage::const_reference var1, Symbol3 var2)
 // Return true if non-dummy variables in two expressions are disjoint.
 bool checkDV
     (Symbol3s const & set1, Symbol3s const & set2, Disjvars const & DV,
-     Varusage const & varusage, bool verbose = true)
+     Varusage const & varusage, bool verbose)
 {
     // Check if two expressions share a common variable.
     if (!is_disjoint(set1.begin(), set1.end(), set2.begin(), set2.end()))
     {
         if (verbose)
-            std::cerr << set1 << "and" << set2 << "have a common variable\n";
+            errs() << set1 << "and" << set2 << "have a common variable\n";
         return false;
     }
 
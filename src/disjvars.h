@@ -4,6 +4,7 @@
 #include <algorithm>    // for std::remove_copy_if
 #include <iosfwd>
 #include "types.h"
+#include "util/bits.h"   // for util::nwords
 #include "util/iter.h"
 
 std::ostream & operator<<(std::ostream & out, Disjvars const & disjvars);
@@ -18,6 +19,37 @@ Disjvars operator &(Disjvars const & disjvars, Varusage const & varusage);
 bool checkDV
     (Symbol3s const & set1, Symbol3s const & set2, Disjvars const & DV,
      Varusage const & varusage, bool verbose = true);
+// Bitmask of variables, by dense index
+typedef std::vector<std::size_t> Varmask;
+
+// Disjoint variable hypotheses on the variables of a statement,
+// as a bit-matrix over their dense indices in varusage order
+class DVmatrix
+{
+public:
+    DVmatrix() {}
+    DVmatrix(Disjvars const & DV, Varusage const & varusage);
+    // Mask of the variables in an RPN.
+    // Return false if it has a variable not in the statement.
+    bool mask(RPN const & rpn, Varmask & result) const;
+    // Clear a mask.
+    void clear(Varmask & mask) const
+    { mask.assign(util::nwords<std::size_t>(m_rows.size()), 0); }
+    // Add a variable to a mask. Return false if it is not in the statement.
+    bool add(Symbol2::ID id, Varmask & mask) const;
+    // Return true if variables in two masks are disjoint and
+    // satisfy the disjoint variable hypotheses.
+    bool check(Varmask const & x, Varmask const & y) const;
+private:
+    // m_index[id] = dense index of the variable with the id + 1, 0 if none
+    std::vector<std::size_t> m_index;
+    // m_rows[i] = mask of the variables disjoint from variable i
+    std::vector<Varmask> m_rows;
+    // Dense index of a variable + 1, 0 if none
+    std::size_t index(Symbol2::ID id) const
+    { return id < m_index.size() ? m_index[id] : 0; }
+};
+
 template<class It> bool checkDV
     (std::pair<It, It> exp1, std::pair<It, It> exp2, Disjvars const & DV,
      Varusage const & varusage)
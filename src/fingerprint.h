@@ -0,0 +1,71 @@
+#ifndef FINGERPRINT_H_INCLUDED
+#define FINGERPRINT_H_INCLUDED
+
+#include <cstddef>  // for std::size_t
+#include <limits>   // for digits
+#include <vector>
+
+// Truth values of a formula under a fixed set of pseudo-random assignments,
+// one assignment per bit
+struct Fingerprint
+{
+    typedef std::size_t Word;
+    static const std::size_t WORDBITS = std::numeric_limits<Word>::digits;
+    static const std::size_t NBITS = 256;
+    static const std::size_t NWORDS = NBITS / WORDBITS;
+    Word words[NWORDS];
+    // All false
+    Fingerprint() { for (std::size_t i = 0; i < NWORDS; ++i) words[i] = 0; }
+    // Truth values of an atom, determined by the seed
+    static Fingerprint random(std::size_t seed)
+    {
+        Fingerprint result;
+        unsigned long counter = seed * NWORDS * (WORDBITS / 16);
+        for (std::size_t i = 0; i < NWORDS; ++i)
+            for (std::size_t bit = 0; bit < WORDBITS; bit += 16)
+                result.words[i] |= static_cast<Word>(mix(counter++) & 0xFFFF)
+                                    << bit;
+        return result;
+    }
+    Fingerprint operator~() const
+    {
+        Fingerprint result;
+        for (std::size_t i = 0; i < NWORDS; ++i)
+            result.words[i] = ~words[i];
+        return result;
+    }
+    Fingerprint & operator&=(Fingerprint const & other)
+    {
+        for (std::size_t i = 0; i < NWORDS; ++i)
+            words[i] &= other.words[i];
+        return *this;
+    }
+    Fingerprint & operator|=(Fingerprint const & other)
+    {
+        for (std::size_t i = 0; i < NWORDS; ++i)
+            words[i] |= other.words[i];
+        return *this;
+    }
+    // Return true if *this => other under all the assignments.
+    // If not, the formulas behind them do not imply each other.
+    bool implies(Fingerprint const & other) const
+    {
+        for (std::size_t i = 0; i < NWORDS; ++i)
+            if (words[i] & ~other.words[i])
+                return false;
+        return true;
+    }
+private:
+    // Integer hash with good avalanche
+    static unsigned long mix(unsigned long x)
+    {
+        x &= 0xFFFFFFFFUL;
+        x = ((x >> 16) ^ x) * 0x45d9f3bUL & 0xFFFFFFFFUL;
+        x = ((x >> 16) ^ x) * 0x45d9f3bUL & 0xFFFFFFFFUL;
+        return (x >> 16) ^ x;
+    }
+};
+
+typedef std::vector<Fingerprint> Fingerprints;
+
+#endif // FINGERPRINT_H_INCLUDED
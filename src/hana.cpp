@@ -1,4 +1,5 @@
 #include <cstdlib>  // for EXIT_..., std::size_t
+#include <cstring>  // for std::strcmp and std::strlen
 #include <fstream>
 #include "comment.h"
 #include "database.h"
@@ -7,7 +8,9 @@
 #include "propctor.h"
 #include "search/problem.h"
 #include "sect.h"
+#include "snapshot.h"
 #include "token.h"
+#include "util/thread.h"
 #include "util/timer.h"
 
 // Pre-run test
@@ -30,10 +33,15 @@ bool ismmfile(const char * filename)
 }
 
 // Configuration only
-int config(const char * cmd, const char * filename)
+int config(const char * cmd, const char * filename, const char * arg)
 {
     switch (std::tolower(static_cast<unsigned char>(cmd[0])))
     {
+    case 'b':
+        bool testread(const char * filename, unsigned copies);
+        if (!arg || !testread(arg, 8))
+            return EXIT_FAILURE;
+        return EXIT_SUCCESS;
     case 'r':
         if (!Param::default.save(filename))
             return EXIT_FAILURE;
@@ -46,42 +54,99 @@ int config(const char * cmd, const char * filename)
     }
 }
 
-// Read tokens. Return true if okay.
-bool read(const char * filename, Tokens & tokens, Comments & comments)
+// Read tokens, up to the section whose title begins with section
+// if it is not NULL. Return true if okay.
+bool read(const char * filename, Tokens & tokens, Comments & comments,
+          const char * section)
 {
     std::cout << "Reading file " << filename << ' ';
+    if (section)
+        std::cout << "up to " << section << ' ';
     Timer timer;
-    bool doread(const char * filename, Tokens & tokens, Comments & comments);
-    if (!doread(filename, tokens, comments)) return false;
+    bool doread(const char * filename, Tokens & tokens, Comments & comments,
+                unsigned nthreads, const char * section);
+    if (!doread(filename, tokens, comments, util::nthreads(), section))
+        return false;
     std::cout << "done in " << timer << 's' << std::endl;
     return true;
 }
 
-bool addRPN(Database & database)
+// Add RPNs, from the snapshot if there is one. Return true if okay.
+bool addRPN(Database & database, Snapshot const * snapshot)
 {
-    std::cout << "Parsing RPN";
-    Timer timer;
-    if (!database.addRPN()) return false;
-    std::cout << "done in " << timer << 's' << std::endl;
-
-    std::cout << "Testing RPN";
-    timer.reset();
-    if (!database.checkRPN()) return false;
-    std::cout << "done in " << timer << 's' << std::endl;
-    database.addtheorempool();
+    if (snapshot)
+    {
+        std::cout << "Loading RPN from snapshot ";
+        Timer timer;
+        if (!database.addRPN(*snapshot)) return false;
+        std::cout << "done in " << timer << 's' << std::endl;
+    }
+    else
+    {
+        std::cout << "Parsing RPN";
+        Timer timer;
+        if (!database.addRPN()) return false;
+        std::cout << "done in " << timer << 's' << std::endl;
+
+        std::cout << "Testing RPN";
+        timer.reset();
+        if (!database.checkRPN()) return false;
+        std::cout << "done in " << timer << 's' << std::endl;
+    }
+    return true;
+}
 
+// Load definitions, the syntax DAG and propositional syntax constructors.
+// Return true if okay.
+bool loaddefinitions(Database & database)
+{
     database.loaddefinitions();
     std::cout << "Primitive syntax axioms\n" << database.primitivesyntaxioms();
+    if (!database.checkdefinitions()) return false;
 
-    return database.checkdefinitions();
+    database.buildsyntaxDAG();
+    std::cout << database.syntaxDAG();
+
+    Propctors const * p = database.info().set("Propctors", Propctors(database));
+    return p->check(database.definitions());
 }
 
-bool loadprop(Database & database)
+// The two phases after adding RPNs that are independent of each other.
+// They are the only phases that overlap. Adding and checking RPNs comes
+// before both, and marking propositional assertions and checking their
+// soundness come after both. Adding RPNs and the soundness check are
+// parallel within themselves.
+struct Postload
 {
-    Propctors const * p = database.info().set("Propctors", Propctors(database));
-    if (!p->check(database.definitions())) return false;
+    Database & database;
+    bool okay[2];
+    Time time[2];
+    Postload(Database & database) : database(database) {}
+    // Run phase i: 0 = theorem pool (silent), 1 = definitions.
+    void operator()(std::size_t i)
+    {
+        Timer timer;
+        if (i == 0)
+            database.addtheorempool(), okay[i] = true;
+        else
+            okay[i] = loaddefinitions(database);
+        time[i] = timer;
+    }
+};
 
-    printpercent(p->markassertions
+// Run the phases after adding RPNs, the first two at the same time.
+// Return true if okay.
+bool postload(Database & database)
+{
+    // The theorem pool is built while the definitions are loaded.
+    Postload phases(database);
+    util::parallel_for(2, phases);
+    std::cout << "Theorem pool built in " << phases.time[0] << 's' << std::endl;
+    std::cout << "Definitions loaded in " << phases.time[1] << 's' << std::endl;
+    if (!phases.okay[1]) return false;
+
+    // Marking changes the types the theorem pool reads, so it comes after.
+    printpercent(GETINFO(database, Propctors).markassertions
                  (const_cast<Assertions&>(database.assertions()),
                  database.typecodes()), "/",
                  database.assertions().size(), " propositional assertions\n");
@@ -104,11 +169,11 @@ int main(int argc, char * argv[])
     static const char paramfilename[] = "param.bin";
 
     if (!ismmfile(argv[1]))
-        return config(argv[1], paramfilename);
+        return config(argv[1], paramfilename, argv[2]);
 
     Tokens tokens;
     Comments comments;
-    if (!read(argv[1], tokens, comments))
+    if (!read(argv[1], tokens, comments, argv[2]))
         return EXIT_FAILURE;
 
     Sections const sections(comments);
@@ -123,21 +188,38 @@ int main(int argc, char * argv[])
     // # tokens to read
     std::size_t size(end == sections.end() ? tokens.size() :
                      end->second.tokenpos());
-    std::cout << "Reading and verifying " << size << " tokens";
+    // Snapshot of the results of processing the same source
+    std::string const snapshotname(std::string(argv[1]) + ".snapshot");
+    std::size_t const hash = hashsource(tokens, size);
+    Snapshot snapshot;
+    bool const hassnapshot = snapshot.read(snapshotname.c_str(), hash);
+    if (hassnapshot)
+        std::cout << "Using snapshot " << snapshotname << std::endl;
+
+    std::cout << (hassnapshot ? "Reading " : "Reading and verifying ");
+    std::cout << size << " tokens";
     Database database;
     Timer timer;
-    if (!database.read(tokens, comments, size))
+    if (!database.read(tokens, comments, size, !hassnapshot))
         return EXIT_FAILURE;
     std::cout << " done in " << timer << 's' << std::endl;
 
-    if (!addRPN(database))
+    if (!addRPN(database, hassnapshot ? &snapshot : NULL))
         return EXIT_FAILURE;
-    database.buildsyntaxDAG();
-    std::cout << database.syntaxDAG();
 
-    if (!loadprop(database) || !checkprop(database))
+    if (!postload(database) || (!hassnapshot && !checkprop(database)))
         return EXIT_FAILURE;
 
+    if (!hassnapshot && Snapshot(database, hash).save(snapshotname.c_str()))
+        std::cout << "Saved snapshot " << snapshotname << std::endl;
+
+    // Benchmark term generation instead of searching, if asked to.
+    if (argc > 3 && std::strcmp(argv[3], "gen") == 0)
+    {
+        bool testgen(Database const &, strview, std::size_t, std::size_t);
+        return testgen(database, "wff", 3, 7) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
     Param param = Param::default;
     // param.update(paramfilename);
     param.read(paramfilename);
@@ -1,6 +1,21 @@
 #include <cstddef>  // for std::size_t
 #include <iostream>
+#include "io.h"
 #include "util/strview.h"
+#include "util/thread.h"
+
+// Stream for error messages on this thread, or NULL for std::cerr
+#ifdef UTIL_THREADS
+static thread_local std::ostream * perrs = NULL;
+#else
+static std::ostream * perrs = NULL;
+#endif // UTIL_THREADS
+
+// Stream for error messages on this thread, std::cerr unless redirected
+std::ostream & errs() { return perrs ? *perrs : std::cerr; }
+
+Errorsto::Errorsto(std::ostream & out) : old(perrs) { perrs = &out; }
+Errorsto::~Errorsto() { perrs = old; }
 
 std::ostream & operator<<(std::ostream & out, strview str)
 {
@@ -13,7 +28,7 @@ bool is1stle2nd(std::size_t const n, std::size_t const lim,
 {
     if (n <= lim)
         return true;
-    std::cout << n << s1 << lim << s2 << std::endl;
+    errs() << n << s1 << lim << s2 << std::endl;
     return false;
 }
 
@@ -13,6 +13,17 @@
 struct strview;
 std::ostream & operator<<(std::ostream & out, strview str);
 
+// Stream for error messages on this thread, std::cerr unless redirected
+std::ostream & errs();
+// Redirect error messages on this thread to a stream while in scope,
+// e.g., to collect those of a job run in parallel.
+struct Errorsto
+{
+    std::ostream * const old;
+    explicit Errorsto(std::ostream & out);
+    ~Errorsto();
+};
+
 template<class T>
 std::ostream & operator<<(std::ostream & out, const std::vector<T> & v)
 {
@@ -50,18 +61,19 @@ std::ostream & operator<<(std::ostream & out, const std::set<Key, Comp> & set)
 }
 
 template
-<class SyntaxDAG, class RanksDAG = typename SyntaxDAG::RanksDAG>
+<class SyntaxDAG, class Rank = typename SyntaxDAG::Rank>
 std::ostream & operator<<(std::ostream & out, const SyntaxDAG & syntaxDAG)
 {
-    typedef typename SyntaxDAG::RankDAGiter It;
-
-    RanksDAG const & dag = syntaxDAG.ranksDAG();
-    for (It iter1 = dag.begin(); iter1 != dag.end(); ++iter1)
+    for (Rank from = 0; from < syntaxDAG.nranks(); ++from)
     {
-        out << iter1->first << " (" << iter1->second << ") -> ";
-        for (It iter2 = dag.begin(); iter2 != dag.end(); ++iter2)
-            if (dag.reachable(iter1, iter2))
-                out << iter2->first << " (" << iter2->second << ") ";
+        out << syntaxDAG.rankname(from);
+        out << " (" << syntaxDAG.ranknumber(from) << ") -> ";
+        for (Rank to = 0; to < syntaxDAG.nranks(); ++to)
+            if (syntaxDAG.reachable(from, to))
+            {
+                out << syntaxDAG.rankname(to);
+                out << " (" << syntaxDAG.ranknumber(to) << ") ";
+            }
         out << std::endl;
     }
     return out;
@@ -78,7 +90,7 @@ template<class T>
 bool unexpected(bool const condition, const char * const type, const T & value)
 {
     if (condition)
-        std::cerr << "Unexpected " << type << ": " << value << std::endl;
+        errs() << "Unexpected " << type << ": " << value << std::endl;
 
     return condition;
 }
@@ -71,7 +71,7 @@ static bool checkDV
     Subexp exp2(pframe2->begin, pframe2->itersub->first);
     bool okay = checkDV(exp1, exp2, ass.disjvars, ass.varusage);
     if (!okay)
-        std::cerr << "in substitutions for " << pframe1->var
+        errs() << "in substitutions for " << pframe1->var
                   << " and " << pframe2->var << std::endl;
     return okay;
 }
@@ -142,7 +142,7 @@ static bool addsubstframe
 static bool nextsubframe
     (Expiter expbegin, Expiter expend,
      Expression const & exp, Assertion const & ass,
-     Syntaxioms const & syntaxioms, pAss psyntaxiom,
+     Syntaxiomptrs const & syntaxioms, pAss psyntaxiom,
      Subexprecords & recs,
      // Track the substitutions for variables.
      Substack & stack, Substframe::Subexpends & result);
@@ -151,14 +151,10 @@ static bool nextsubframe
 Substframe::Subexpends const & RPNmap
     (strview type, Expiter expbegin, Expiter expend,
      Expression const & exp, Assertion const & ass,
-     struct Syntaxioms const & syntaxioms, Subexprecords & recs)
+     Syntaxiomptrs const & syntaxioms, Subexprecords & recs)
 {
-    // Reserve space for substitutions from begin to end, inclusive.
-    recs[type].resize(exp.size() + 1);
-
     // Check if expbegin has been seen before.
-    std::pair<Substframe::Subexpends, bool> & iter
-        (recs[type][expbegin - exp.begin()]);
+    Subexprecords::Record & iter(recs(type, expbegin - exp.begin()));
     if (iter.second)
         // Yes. Return the recorded result.
         return iter.first;
@@ -172,9 +168,9 @@ Substframe::Subexpends const & RPNmap
         result[expbegin + 1].assign(1, expbegin->iter);
 
     // Match syntax axioms.
-    FOR (Syntaxioms::const_reference syntaxiom, syntaxioms)
+    FOR (Syntaxioms::const_pointer syntaxiom, syntaxioms)
     {
-        pAss psyntaxiom = syntaxiom.second.pass;
+        pAss psyntaxiom = syntaxiom->second.pass;
         Expression const & saexp(psyntaxiom->second.expression);
         if (saexp.empty() || saexp[0] != type)
             continue; // Type mismatch
@@ -207,7 +203,7 @@ Substframe::Subexpends const & RPNmap
 static bool nextsubframe
     (Expiter expbegin, Expiter expend,
      Expression const & exp, Assertion const & ass,
-     Syntaxioms const & syntaxioms, pAss psyntaxiom,
+     Syntaxiomptrs const & syntaxioms, pAss psyntaxiom,
      Subexprecords & recs,
      // Track the substitutions for variables.
      Substack & stack, Substframe::Subexpends & result)
@@ -1,6 +1,7 @@
 #ifndef PARSE_H_INCLUDED
 #define PARSE_H_INCLUDED
 
+#include <deque>
 #include "io.h"
 #include "types.h"
 
@@ -22,14 +23,44 @@ struct Substframe
     { return !unexpected(itersub == ends.end(), "substitution for", var);}
 };
 
-// Map: type -> vector[begin index] = possible ends of substitutions.
-typedef std::map<strview,
-    std::vector<std::pair<Substframe::Subexpends, bool> > > Subexprecords;
+// Chart of sub-parses, flat over (type, begin index):
+// (possible ends of substitutions, seen?)
+// Ends stay in a map, as most sub-parses have few of them,
+// and a dense row of ends per cell would be quadratic in the size.
+struct Subexprecords
+{
+    typedef std::pair<Substframe::Subexpends, bool> Record;
+    // Row width = # begin indices
+    Expression::size_type const width;
+    Subexprecords(Expression::size_type expsize) : width(expsize + 1) {}
+    // Return the record of a type at a begin index.
+    // References stay valid when new types are added.
+    Record & operator()(strview type, Expression::size_type begin)
+    {
+        std::vector<strview>::size_type i = 0;
+        while (i < types.size() && types[i] != type)
+            ++i;
+        if (i == types.size())
+        {
+            types.push_back(type);
+            chart.resize(chart.size() + width);
+        }
+        return chart[i * width + begin];
+    }
+private:
+    // Types seen, in order of rows
+    std::vector<strview> types;
+    std::deque<Record> chart;
+};
+
+// Syntax axioms to try in a parse
+typedef std::vector<std::pair<strview const, struct Syntaxiom> const *>
+    Syntaxiomptrs;
 
 // Return possible substitutions from begin to end of the given type.
 Substframe::Subexpends const & RPNmap
     (strview type, Expiter expbegin, Expiter expend,
      Expression const & exp, Assertion const & ass,
-     struct Syntaxioms const & syntaxioms, Subexprecords & recs);
+     Syntaxiomptrs const & syntaxioms, Subexprecords & recs);
 
 #endif // PARSE_H_INCLUDED
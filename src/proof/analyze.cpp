@@ -1,4 +1,5 @@
 #include <algorithm>    // for std::find and std::lexicographic_compare
+#include <iterator>     // for std::reverse_iterator
 #include "../ass.h"
 #include "compspan.h"
 // #include "../io.h"
@@ -115,6 +116,71 @@ bool findsubst(RPNspanAST exp, RPNspanAST tmp, RPNspans & subst)
     }
 }
 
+// Return the beginning of the subtree of an expression rooted at pos.
+static RPNsize subtreebegin(ASTiter ast, RPNsize pos)
+{
+    while (!ast[pos].empty())
+        pos -= ast[pos].back() + 1 - ast[pos][0];
+    return pos;
+}
+
+// Run matcher instructions, from the root of the template to its leaves,
+// against an expression. Return true if it matches.
+template<class Iter>
+static bool runmatcher(RPNspanAST exp, Iter begin, Iter end, RPNspans & subst)
+{
+    RPNiter const expbegin = exp.first.first;
+    // One past the step of the expression to be matched
+    RPNsize pos = exp.size();
+    for ( ; begin != end; ++begin)
+    {
+        if (pos == 0)
+            return false;
+        --pos;
+        Matchop const op(*begin);
+        switch (op.opcode)
+        {
+        case Matchop::CTOR:
+            if (expbegin[pos].ptr() != op.ptr)
+                return false;
+            continue;
+        case Matchop::VAR:
+            {
+                // Sub-expression substituted for the variable
+                RPNsize const start = subtreebegin(exp.second, pos);
+                RPNspan const subexp(expbegin + start, expbegin + pos + 1);
+                RPNspan & bound = subst[op.id];
+                if (bound.empty())
+                    bound = subexp; // unseen
+                else if (bound != subexp)
+                    return false;   // seen but different
+                pos = start;
+                continue;
+            }
+        default:
+            return false;
+        }
+    }
+    return true;
+}
+
+// Return true if the RPN of an expression matches a compiled template.
+bool findsubst(RPNspanAST exp, Matcher const & tmp, RPNspans & subst)
+{
+    if (exp.empty() || tmp.empty() || exp.size() < tmp.size())
+        return false;
+    return runmatcher(exp, tmp.begin(), tmp.end(), subst);
+}
+
+// Return true if the RPN of an expression matches a template span.
+bool findsubst(RPNspanAST exp, RPNspan tmp, RPNspans & subst)
+{
+    if (exp.empty() || tmp.empty() || exp.size() < tmp.size())
+        return false;
+    typedef std::reverse_iterator<RPNiter> Reviter;
+    return runmatcher(exp, Reviter(tmp.second), Reviter(tmp.first), subst);
+}
+
 // Return true if span1 has all the variables in span2
 static bool hasallvars(RPNspan span1, RPNspan span2)
 {
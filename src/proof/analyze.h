@@ -14,6 +14,15 @@ Indentations indentations(AST const & ast);
 // Return true if the RPN of an expression matches a template.
 bool findsubst(RPNspanAST exp, RPNspanAST tmp, RPNspans & subst);
 
+// Compile a template into a matcher.
+inline Matcher matcher(RPN const & tmp) { return Matcher(tmp.rbegin(), tmp.rend()); }
+
+// Return true if the RPN of an expression matches a compiled template.
+bool findsubst(RPNspanAST exp, Matcher const & tmp, RPNspans & subst);
+
+// Return true if the RPN of an expression matches a template span.
+bool findsubst(RPNspanAST exp, RPNspan tmp, RPNspans & subst);
+
 // All maximal abstractions governed by a syntax axiom.
 GovernedRPNspansbystep maxabs(RPNspanAST exp);
 
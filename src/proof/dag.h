@@ -0,0 +1,117 @@
+#ifndef PROOFDAG_H_INCLUDED
+#define PROOFDAG_H_INCLUDED
+
+#include <algorithm>    // for std::lower_bound, std::max and std::set_union
+#include <iterator>     // for std::back_inserter
+#include <memory>       // for std::shared_ptr
+#include "../ass.h"
+#include "../util/for.h"
+#include "verify.h"
+
+// Node in a DAG of proofs, immutable once built
+struct Proofnode;
+// Shared pointer to a proof node. Null if there is no proof.
+typedef std::shared_ptr<Proofnode const> pProofnode;
+// Pointers to proof nodes
+typedef std::vector<pProofnode> pProofnodes;
+
+// Proof of a goal, with the proofs of its sub-goals shared by reference.
+// Each NONE step stands for the next sub-proof, in order.
+struct Proofnode
+{
+    // Steps, with NONE in place of sub-proofs
+    RPN steps;
+    // Sub-proofs, one for each NONE step
+    pProofnodes subproofs;
+    // Size of the flattened proof
+    RPNsize size;
+    // 1 + max # of theorems used, 0 if none
+    nAss nthm;
+    // Essential hypotheses used, sorted by address
+    std::vector<pHyp> hyps;
+    // Statement proved, once verified
+    Expression conclusion;
+    Proofnode() : size(0), nthm(0) {}
+    // Add a step.
+    void push_back(RPNstep step)
+    {
+        steps.push_back(step), ++size;
+        if (step.isthm())
+            nthm = std::max(nthm, step.pass->second.number + 1);
+        else if (step.ishyp() && !step.phyp->second.floats)
+        {
+            std::vector<pHyp>::iterator const iter = std::lower_bound
+                (hyps.begin(), hyps.end(), step.phyp, std::less<pHyp>());
+            if (iter == hyps.end() || *iter != step.phyp)
+                hyps.insert(iter, step.phyp);
+        }
+    }
+    // Add steps.
+    void append(RPN const & rpn)
+    {
+        FOR (RPNstep const step, rpn)
+            push_back(step);
+    }
+    // Add a sub-proof by reference. Return false if it is null.
+    bool append(pProofnode const & p)
+    {
+        if (!p)
+            return false;
+        steps.push_back(RPNstep());
+        subproofs.push_back(p);
+        size += p->size;
+        nthm = std::max(nthm, p->nthm);
+        std::vector<pHyp> merged;
+        merged.reserve(hyps.size() + p->hyps.size());
+        std::set_union(hyps.begin(), hyps.end(),
+                       p->hyps.begin(), p->hyps.end(),
+                       std::back_inserter(merged), std::less<pHyp>());
+        hyps.swap(merged);
+        return true;
+    }
+    // Verify the steps, taking the conclusions of the sub-proofs.
+    // Return the statement proved.
+    // Return the empty expression if not okay.
+    Expression verify() const
+    {
+        pExpressions subconclusions;
+        subconclusions.reserve(subproofs.size());
+        FOR (pProofnode const & p, subproofs)
+            subconclusions.push_back(&p->conclusion);
+        return ::verify(steps, subconclusions);
+    }
+};
+
+// Return a verified proof of the steps with no sub-proof.
+inline pProofnode makeproof(RPN const & rpn)
+{
+    Proofnode * const p = new Proofnode;
+    pProofnode const result(p);
+    p->append(rpn);
+    p->conclusion = p->verify();
+    return result;
+}
+
+// Append the flattened proof to dest.
+inline void flatten(Proofnode const & proof, RPN & dest)
+{
+    pProofnodes::const_iterator iter = proof.subproofs.begin();
+    FOR (RPNstep const step, proof.steps)
+        if (step.empty())
+            flatten(**iter++, dest);
+        else
+            dest.push_back(step);
+}
+
+// Return the flattened proof. Return the empty proof if p is null.
+inline RPN flatten(pProofnode const & p)
+{
+    RPN result;
+    if (!p)
+        return result;
+    result.reserve(p->size);
+    flatten(*p, result);
+    return result;
+}
+
+#endif // PROOFDAG_H_INCLUDED
@@ -0,0 +1,198 @@
+#ifndef EXPSTORE_H_INCLUDED
+#define EXPSTORE_H_INCLUDED
+
+#include <algorithm>    // for std::equal
+#include "../types.h"
+#include "../util/for.h"
+#include "../util/intern.h"
+
+// Store of the expressions in a proof verification.
+// Symbols are coded by their strings, so that equal codes mean equal symbols.
+// Statements read carry the codes of their symbols, which are translated
+// by table lookup, so each of their symbols is interned only once.
+// Expressions are hash-consed: each distinct expression is kept once,
+// back to back in an arena, and referred to by its index.
+struct Expstore
+{
+    // Range of symbols [first, second) in the arena
+    typedef std::pair<std::size_t, std::size_t> Range;
+    // Index of an expression
+    typedef std::vector<Range>::size_type Index;
+    // Substitution vector, by variable ID
+    typedef std::vector<Range> Substitutions;
+    Expstore() : m_symbols(1), m_slots(16) {}
+    // Return the index of an expression, with the codes of its symbols read.
+    // Codes are ignored unless there is one for each symbol.
+    Index add(Expression const & exp, Symbolcodes const & codes)
+    {
+        std::map<Expression const *, Index>::iterator const iter
+            = m_cache.find(&exp);
+        if (iter != m_cache.end())
+            return iter->second;
+
+        std::size_t const begin = m_arena.size();
+        if (codes.size() == exp.size())
+            for (Expression::size_type i = 0; i < exp.size(); ++i)
+                m_arena.push_back(code(exp[i], codes[i]));
+        else
+            FOR (Symbol3 const & symbol, exp)
+                m_arena.push_back(code(symbol));
+        return m_cache[&exp] = close(begin);
+    }
+    // Return the index of an expression not read.
+    Index operator[](Expression const & exp)
+    { return add(exp, Symbolcodes()); }
+    // Return the index of the expression of a hypothesis.
+    Index operator[](Hypothesis const & hyp)
+    { return add(hyp.expression, hyp.codes); }
+    // # expressions
+    Index size() const { return m_ranges.size(); }
+    // Range of an expression
+    Range range(Index exp) const { return m_ranges[exp]; }
+    // Code of the symbol at a position in the arena
+    Symbolcode at(std::size_t pos) const { return m_arena[pos]; }
+    // Code of the first symbol of an expression
+    Symbolcode front(Index exp) const { return m_arena[m_ranges[exp].first]; }
+    // ID of the variable with a code, 0 for constants
+    Symbol2::ID id(Symbolcode code) const { return m_symbols[code].id; }
+    // Return the index of the substitution into an expression.
+    Index subst(Index src, Substitutions const & substs)
+    {
+        std::size_t const begin = m_arena.size();
+        for (std::size_t i = m_ranges[src].first; i < m_ranges[src].second; ++i)
+        {
+            Symbolcode const code = m_arena[i];
+            Symbol2::ID const varid = id(code);
+            if (!varid)
+            {
+                m_arena.push_back(code);
+                continue;
+            }
+            // Copy by index, as the arena may grow.
+            Range const sub = substs[varid];
+            for (std::size_t j = sub.first; j < sub.second; ++j)
+            {
+                Symbolcode const subcode = m_arena[j];
+                m_arena.push_back(subcode);
+            }
+        }
+        return close(begin);
+    }
+    // Return true if the substitution into src equals exp,
+    // without building the substitution.
+    bool substequals(Index src, Substitutions const & substs, Index exp) const
+    {
+        Range const range = m_ranges[exp];
+        std::size_t pos = range.first;
+        for (std::size_t i = m_ranges[src].first; i < m_ranges[src].second; ++i)
+        {
+            Symbolcode const code = m_arena[i];
+            if (Symbol2::ID const varid = id(code))
+            {
+                Range const sub = substs[varid];
+                std::size_t const size = sub.second - sub.first;
+                if (range.second - pos < size ||
+                    !std::equal(m_arena.begin() + sub.first,
+                                m_arena.begin() + sub.second,
+                                m_arena.begin() + pos))
+                    return false;
+                pos += size;
+            }
+            else if (pos == range.second || m_arena[pos++] != code)
+                return false;
+        }
+        return pos == range.second;
+    }
+    // Expand a range of symbols.
+    Expression decode(Range range) const
+    {
+        Expression result;
+        result.reserve(range.second - range.first);
+        for (std::size_t i = range.first; i < range.second; ++i)
+            result.push_back(m_symbols[m_arena[i]]);
+        return result;
+    }
+    Expression decode(Index exp) const { return decode(m_ranges[exp]); }
+private:
+    // Map: string of a symbol -> its code
+    util::Interner m_codes;
+    // m_symbols[code] = symbol with the code
+    std::vector<Symbol3> m_symbols;
+    // Codes of all the expressions, back to back
+    std::vector<Symbolcode> m_arena;
+    // m_ranges[index] = range of the expression with the index
+    std::vector<Range> m_ranges;
+    // Open-addressing hash table: slot -> expression index + 1, 0 if empty
+    std::vector<Index> m_slots;
+    // Map: expression in a hypothesis or assertion -> its index
+    std::map<Expression const *, Index> m_cache;
+    // m_local[code read] = code in the store, 0 if not seen yet
+    std::vector<Symbolcode> m_local;
+    // Return the code of a symbol, adding it if new.
+    Symbolcode code(Symbol3 const & symbol)
+    {
+        Symbolcode const result = m_codes.add(symbol);
+        if (result == m_symbols.size())
+            m_symbols.push_back(symbol);
+        return result;
+    }
+    // Return the code of a symbol with a code read, adding it if new.
+    Symbolcode code(Symbol3 const & symbol, Symbolcode coderead)
+    {
+        if (coderead >= m_local.size())
+            m_local.resize(coderead + 1);
+        Symbolcode & result = m_local[coderead];
+        if (!result)
+            result = code(symbol);
+        return result;
+    }
+    // FNV-1a hash of a range of symbols
+    std::size_t hash(Range range) const
+    {
+        std::size_t h = 2166136261u;
+        for (std::size_t i = range.first; i < range.second; ++i)
+            h = (h ^ m_arena[i]) * 16777619u;
+        return h;
+    }
+    // Return true if two ranges hold the same symbols.
+    bool equal(Range x, Range y) const
+    {
+        return x.second - x.first == y.second - y.first &&
+            std::equal(m_arena.begin() + x.first, m_arena.begin() + x.second,
+                       m_arena.begin() + y.first);
+    }
+    // Return the slot holding a range, or the empty slot to put it in.
+    std::size_t findslot(Range range) const
+    {
+        std::size_t const mask = m_slots.size() - 1;
+        std::size_t slot = hash(range) & mask;
+        while (m_slots[slot] && !equal(m_ranges[m_slots[slot] - 1], range))
+            slot = (slot + 1) & mask;
+        return slot;
+    }
+    // Close the expression written from begin to the end of the arena.
+    // Return its index, sharing an equal expression already stored.
+    Index close(std::size_t begin)
+    {
+        Range const range(begin, m_arena.size());
+        std::size_t slot = findslot(range);
+        if (m_slots[slot])
+        {
+            m_arena.resize(begin);
+            return m_slots[slot] - 1;
+        }
+        // Keep the load factor under 1/2.
+        if (2 * m_ranges.size() >= m_slots.size())
+        {
+            std::vector<Index>(2 * m_slots.size()).swap(m_slots);
+            for (Index i = 0; i < m_ranges.size(); ++i)
+                m_slots[findslot(m_ranges[i])] = i + 1;
+            slot = findslot(range);
+        }
+        m_ranges.push_back(range);
+        m_slots[slot] = m_ranges.size();
+        return m_ranges.size() - 1;
+    }
+};
+
+#endif // EXPSTORE_H_INCLUDED
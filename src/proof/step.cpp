@@ -1,5 +1,6 @@
 #include <iostream>
 #include "../ass.h"
+#include "../io.h"
 #include "../util/for.h"
 
 static const char steperr[] = "Invalid proof step ";
@@ -31,7 +32,7 @@ RPNstep::operator const char*() const
         if (!pass) return NULL;
         return pass->first.c_str;
     case LOAD: case SAVE:
-        std::cerr << steperr << "of type " << type << std::endl;
+        errs() << steperr << "of type " << type << std::endl;
     default:
         return NULL;
     }
@@ -48,18 +49,18 @@ RPNstep RPNstep::Builder::operator()(strview label) const
     if (assiter != m_assertions.end())
         return &*assiter;
 
-    std::cerr << steperr << label.c_str << std::endl;
+    errs() << steperr << label.c_str << std::endl;
     return RPNstep();
 }
 
 static void writeprooferr(const char * thmlabel)
 {
-    std::cerr << "When writing proof using " << thmlabel;
+    errs() << "When writing proof using " << thmlabel;
 }
 
 static void hypothesiserr(const char * hyplabel)
 {
-    std::cerr << ", hypothesis " << hyplabel;
+    errs() << ", hypothesis " << hyplabel;
 }
 
 // Write the proof from pointers to proof of hypotheses. Return true if Okay.
@@ -69,8 +70,8 @@ bool writeproof(RPN & dest, pAss pthm, pProofs const & hyps)
     if (hyps.size() != pthm->second.nhyps())
     {
         writeprooferr(pthm->first.c_str);
-        std::cerr << ", expected " << pthm->second.nhyps() << " hypotheses";
-        std::cerr << ", but found " << hyps.size() << std::endl;
+        errs() << ", expected " << pthm->second.nhyps() << " hypotheses";
+        errs() << ", but found " << hyps.size() << std::endl;
         return false;
     }
     // Total length ( +1 for label)
@@ -82,14 +83,14 @@ bool writeproof(RPN & dest, pAss pthm, pProofs const & hyps)
         {
             writeprooferr(pthm->first.c_str);
             hypothesiserr(pthm->second.hyplabel(i).c_str);
-            std::cerr << " has no proof" << std::endl;
+            errs() << " has no proof" << std::endl;
             return false;
         }
         if (phyp == &dest)
         {
             writeprooferr(pthm->first.c_str);
             hypothesiserr(pthm->second.hyplabel(i).c_str);
-            std::cerr << " is the same as the conclusion" << std::endl;
+            errs() << " is the same as the conclusion" << std::endl;
             return false;
         }
         length += phyp->size();
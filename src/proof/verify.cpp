@@ -3,12 +3,13 @@
 #include "../disjvars.h"
 #include "../io.h"
 #include "printer.h"
+#include "expstore.h"
 #include "../util/filter.h"
 #include "../util/msg.h"
 #include "verify.h"
 
 // Substitution vector
-typedef std::vector<std::pair<const Symbol3 *, const Symbol3 *> > Substitutions;
+typedef Expstore::Substitutions Substitutions;
 
 // Extract proof steps from a compressed proof.
 RPN compressed(RPN const & labels, Proofnumbers const & proofnumbers)
@@ -42,7 +43,7 @@ RPN regular
 static bool printinproofof(strview label, bool okay = false)
 {
     if (!okay)
-        std::cerr << " in proof of theorem " << label << std::endl;
+        errs() << " in proof of theorem " << label << std::endl;
     return okay;
 }
 
@@ -58,77 +59,97 @@ static void printunificationfailure
     (strview label, strview thmlabel, Hypothesis const & hyp,
      Expression const & dest, Expression const & stackitem)
 {
-    std::cerr << "In step " << thmlabel; printinproofof(label);
-    std::cerr << (hyp.floats ? "floating" : "essential") << " hypothesis ";
-    std::cerr << hyp.expression << "expanded to\n" << dest;
-    std::cerr << "does not match stack item\n" << stackitem;
+    errs() << "In step " << thmlabel; printinproofof(label);
+    errs() << (hyp.floats ? "floating" : "essential") << " hypothesis ";
+    errs() << hyp.expression << "expanded to\n" << dest;
+    errs() << "does not match stack item\n" << stackitem;
 }
 
 static void printdisjvarserr
     (strview var1,Expression const & exp1,strview var2,Expression const & exp2,
      Disjvars const & DV)
 {
-    std::cerr << "The substitutions\n" << var1 << ":\t" << exp1;
-    std::cerr << var2 << ":\t" << exp2;
-    std::cerr << "violate disjoint variable hypothesis\n";
-    std::cerr << "Disjoint variable hypotheses of the assertion:\n" << DV;
+    errs() << "The substitutions\n" << var1 << ":\t" << exp1;
+    errs() << var2 << ":\t" << exp2;
+    errs() << "violate disjoint variable hypothesis\n";
+    errs() << "Disjoint variable hypotheses of the assertion:\n" << DV;
 }
 
+// Checker of the disjoint variable hypotheses of the assertion proved,
+// on the codes of the substitutions
+class DVchecker
+{
+public:
+    DVchecker(pAss pass) : m_stamp(0)
+    {
+        if (pass)
+            m_DV = DVmatrix(pass->second.disjvars, pass->second.varusage);
+    }
+    // Return true if the variables in two ranges are disjoint and
+    // satisfy the disjoint variable hypotheses.
+    // Variables not in the statement are only checked to be disjoint.
+    bool operator()
+        (Expstore const & store, Expstore::Range x, Expstore::Range y)
+    {
+        ++m_stamp;
+        m_DV.clear(m_x), m_DV.clear(m_y);
+        for (std::size_t i = x.first; i < x.second; ++i)
+            if (Symbol2::ID const id = store.id(store.at(i)))
+            {
+                if (id >= m_marks.size())
+                    m_marks.resize(id + 1);
+                m_marks[id] = m_stamp;
+                m_DV.add(id, m_x);
+            }
+        for (std::size_t i = y.first; i < y.second; ++i)
+            if (Symbol2::ID const id = store.id(store.at(i)))
+            {
+                if (id < m_marks.size() && m_marks[id] == m_stamp)
+                    return false;
+                m_DV.add(id, m_y);
+            }
+        return m_DV.check(m_x, m_y);
+    }
+private:
+    DVmatrix m_DV;
+    // Masks of the variables in the statement, in the two ranges
+    Varmask m_x, m_y;
+    // m_marks[id] = m_stamp if the variable is in the first range
+    std::vector<std::size_t> m_marks;
+    std::size_t m_stamp;
+};
+
 // Check disjoint variable hypothesis in verifying an assertion reference.
+// Decode the substitutions only to print the error.
 static bool checkDV
-    (Substitutions const & substs, Disjvars const & thmDV, Assertion const & ass)
+    (Substitutions const & substs, Disjvars const & thmDV, Assertion const & ass,
+     DVchecker & checker, Expstore const & store)
 {
     FOR (Disjvars::const_reference vars, thmDV)
     {
-        Substitutions::value_type exp1(substs[vars.first]);
-        Substitutions::value_type exp2(substs[vars.second]);
-
-        if (!checkDV(exp1, exp2, ass.disjvars, ass.varusage))
-        {
-            printdisjvarserr(vars.first, Expression(exp1.first, exp1.second),
-                             vars.second, Expression(exp2.first, exp2.second),
-                             ass.disjvars);
-            return false;
-        }
+        if (checker(store, substs[vars.first], substs[vars.second]))
+            continue;
+
+        Expression const exp1(store.decode(substs[vars.first]));
+        Expression const exp2(store.decode(substs[vars.second]));
+        checkDV(Subexp(exp1.begin(), exp1.end()),
+                Subexp(exp2.begin(), exp2.end()),
+                ass.disjvars, ass.varusage);
+        printdisjvarserr(vars.first, exp1, vars.second, exp2, ass.disjvars);
+        return false;
     }
 
     return true;
 }
 
-static Expression::size_type substsize
-    (Expression const & src, Substitutions const & substs)
-{
-    Expression::size_type size = 0;
-    FOR (Symbol3 symbol, src)
-        if (Symbol3::ID const id = symbol.id)
-            size += substs[id].second - substs[id].first;
-        else
-            ++size;
-    return size;
-}
-
-static void makesubst
-    (Expression const & src, Expression & dest, Substitutions const & substs)
-{
-    if (substs.empty())
-        return dest.assign(src.begin(), src.end());
-    // Preallocate for efficiency
-    dest.reserve(substsize(src, substs));
-    // Make the substitution
-    FOR (Symbol3 symbol, src)
-        if (Symbol3::ID const id = symbol.id)
-            dest += substs[id];
-        else
-            dest.push_back(symbol);
-}
-
 // Find the substitution. Increase the size of the stack by 1.
 // Return index of the base of the substitution in the stack.
 // Return the size of the stack if not okay.
 template<class HYPS>
-static std::vector<Expression>::size_type findsubst
+static std::vector<Expstore::Index>::size_type findsubst
     (strview label, strview thmlabel, HYPS const & hyps,
-     std::vector<Expression> & stack, Substitutions & substs)
+     std::vector<Expstore::Index> & stack, Substitutions & substs,
+     Expstore & store)
 {
     Hypsize const nhyps = hyps.size(), oldstacksize = stack.size();
     if (!enoughitemonstack(nhyps, oldstacksize, label))
@@ -143,29 +164,32 @@ static std::vector<Expression>::size_type findsubst
     for (Hypsize i = 0; i < nhyps; ++i)
     {
         Hypothesis const & hypothesis = hyps[i]->second;
+        Expstore::Index const hypexp = store[hypothesis];
+        Expstore::Index const stackitem = stack[base + i];
         if (hypothesis.floats)
         {
             // Floating hypothesis of the referenced assertion
-            if (hypothesis.expression[0] != stack[base + i][0])
+            if (store.front(hypexp) != store.front(stackitem))
             {
                 printunificationfailure(label, thmlabel, hypothesis,
-                                        hypothesis.expression, stack[base + i]);
+                                        hypothesis.expression,
+                                        store.decode(stackitem));
                 return oldstacksize + 1;
             }
             Symbol2::ID const id = hypothesis.expression[1];
             substs.resize(std::max(id + 1, substs.size()));
-            substs[id]
-            = std::make_pair(&stack[base + i][1], &stack[base + i].back() + 1);
+            Expstore::Range const range = store.range(stackitem);
+            substs[id] = Expstore::Range(range.first + 1, range.second);
         }
         else
         {
             // Essential hypothesis
-            Expression dest;
-            makesubst(hypothesis.expression, dest, substs);
-            if (dest != stack[base + i])
+            if (!store.substequals(hypexp, substs, stackitem))
             {
+                Expstore::Index const dest = store.subst(hypexp, substs);
                 printunificationfailure(label, thmlabel, hypothesis,
-                                        dest, stack[base + i]);
+                                        store.decode(dest),
+                                        store.decode(stackitem));
                 return oldstacksize + 1;
             }
         }
@@ -177,8 +201,8 @@ static std::vector<Expression>::size_type findsubst
 // Subroutine for proof verification. Verify a proof step referencing an
 // assertion (i.e., not a hypothesis).
 static bool verifystep
-    (pAss pass, pAss pthm, std::vector<Expression> & stack,
-     Substitutions & substs)
+    (pAss pass, pAss pthm, std::vector<Expstore::Index> & stack,
+     Substitutions & substs, DVchecker & checker, Expstore & store)
 {
     strview label = pass ? pass->first : "";
     Assertion const & thm = pthm->second;
@@ -186,21 +210,22 @@ static bool verifystep
     // Find the necessary substitutions.
     substs.clear();
     substs.resize(thm.maxvarid + 1);
-    std::vector<Expression>::size_type const base = findsubst
-        (label, pthm->first, pthm->second.hypiters, stack, substs);
+    std::vector<Expstore::Index>::size_type const base = findsubst
+        (label, pthm->first, pthm->second.hypiters, stack, substs, store);
     if (base == stack.size())
         return false;
 //std::cout << "Substitutions" << std::endl << substs;
 
     // Verify disjoint variable conditions.
-    if (pass && !checkDV(substs, thm.disjvars, pass->second))
+    if (pass &&
+        !checkDV(substs, thm.disjvars, pass->second, checker, store))
     {
-        std::cerr << "In step " << pthm->first;
+        errs() << "In step " << pthm->first;
         return printinproofof(label);
     }
 
     // Insert new statement onto stack.
-    makesubst(thm.expression, stack.back(), substs);
+    stack.back() = store.subst(store.add(thm.expression, thm.codes), substs);
     // Remove hypotheses from stack.
     stack.erase(stack.begin() + base, stack.end() - 1);
 
@@ -216,13 +241,22 @@ static bool enoughsavedsteps
 }
 
 // Subroutine for proof verification. Verify proof steps.
-Expression verify(RPN const & proof, Printer & printer, pAss pass)
+// Each NONE step stands for the next of the subconclusions.
+// Return the index of the statement proved in the store.
+// Return the size of the store if not okay.
+static Expstore::Index verify
+    (RPN const & proof, Printer & printer, pAss pass,
+     pExpressions const & subconclusions, Expstore & store)
 {
     strview label = pass ? pass->first : "";
 //std::cout << "Verifying " << label << std::endl;
-    std::vector<Expression> stack, savedsteps;
+    // Stack items and saved steps refer to expressions in the store.
+    std::vector<Expstore::Index> stack, savedsteps;
+    // Next of the subconclusions
+    pExpressions::const_iterator subiter = subconclusions.begin();
 
     Substitutions substs;
+    DVchecker checker(pass);
 
     FOR (RPNstep const & step, proof)
     {
@@ -230,51 +264,77 @@ Expression verify(RPN const & proof, Printer & printer, pAss pass)
         {
         case RPNstep::HYP:
 //std::cout << "Pushing hypothesis: " << step.phyp->first << '\n';
-            stack.push_back(step.phyp->second.expression);
+            stack.push_back(store[step.phyp->second]);
             break;
         case RPNstep::THM:
 //std::cout << "Applying assertion: " << step.pass->first << '\n';
-            if (!verifystep(pass, step.pass, stack, substs))
-                return Expression();
+            if (!verifystep(pass, step.pass, stack, substs, checker, store))
+                return store.size();
             break;
         case RPNstep::LOAD:
 //std::cout << "Loading saved step " << step.index << std::endl;
             if (!enoughsavedsteps(step.index, savedsteps.size(), label))
-                return Expression();
+                return store.size();
             stack.push_back(savedsteps[step.index]);
             break;
         case RPNstep::SAVE:
 //std::cout << "Saving step " << savedsteps.size() << std::endl;
             if (stack.empty())
             {
-                std::cerr << "No step to save";
+                errs() << "No step to save";
                 printinproofof(label);
-                return Expression();
+                return store.size();
             }
             savedsteps.push_back(stack.back());
             break;
+        case RPNstep::NONE:
+            if (subiter != subconclusions.end() && !(*subiter)->empty())
+            {
+                stack.push_back(store[**subiter++]);
+                break;
+            }
+            // No statement for the step. Fall through.
         default:
-            std::cerr << "Invalid step";
+            errs() << "Invalid step";
             printinproofof(label);
-            return Expression();
+            return store.size();
         }
-        if (!printer.addstep(step, &step - &proof[0], stack.back()))
-            return Expression();
+        if (printer && !printer.addstep(step, &step - &proof[0],
+                                        store.decode(stack.back())))
+            return store.size();
     }
 
     if (stack.size() != 1)
     {
-        std::cerr << "Proof of theorem " << label << stackszerr << std::endl;
-        return Expression();
+        errs() << "Proof of theorem " << label << stackszerr << std::endl;
+        return store.size();
     }
 
-    return Expression(stack[0].begin(), stack[0].end());
+    return stack[0];
+}
+static Expression verify
+    (RPN const & proof, Printer & printer, pAss pass,
+     pExpressions const & subconclusions)
+{
+    Expstore store;
+    Expstore::Index const exp
+        = verify(proof, printer, pass, subconclusions, store);
+    return exp < store.size() ? store.decode(exp) : Expression();
+}
+Expression verify(RPN const & proof, Printer & printer, pAss pass)
+{
+    return verify(proof, printer, pass, pExpressions());
 }
 Expression verify(RPN const & proof, pAss pass)
 {
     Printer printer;
     return verify(proof, printer, pass);
 }
+Expression verify(RPN const & proof, pExpressions const & subconclusions)
+{
+    Printer printer;
+    return verify(proof, printer, pAss(), subconclusions);
+}
 
 // Verify a regular proof. The "proof" argument should be a non-empty sequence
 // of valid labels. Return the statement the "proof" proves.
@@ -304,7 +364,25 @@ bool checkconclusion
     if (conclusion == expression)
         return true;
 
-    std::cerr << "Proof of theorem " << label << " proves wrong statement:\n"
+    errs() << "Proof of theorem " << label << " proves wrong statement:\n"
               << conclusion << "instead of:\n" << expression;
     return false;
 }
+
+// Return if the proof of an assertion proves its statement.
+// Compare the codes of the symbols, and decode them only to print an error.
+bool checkconclusion(RPN const & proof, pAss pass)
+{
+    Printer printer;
+    Expstore store;
+    Expstore::Index const conclusion
+        = verify(proof, printer, pass, pExpressions(), store);
+    bool const okay = conclusion < store.size();
+    Assertion const & ass = pass->second;
+    if (okay && conclusion == store.add(ass.expression, ass.codes))
+        return true;
+
+    return checkconclusion(pass->first,
+                           okay ? store.decode(conclusion) : Expression(),
+                           ass.expression);
+}
@@ -7,6 +7,8 @@
 
 // Proof is a sequence of labels.
 typedef std::vector<std::string> Proof;
+// Pointers to expressions
+typedef std::vector<Expression const *> pExpressions;
 
 // Extract proof steps from a compressed proof.
 RPN compressed(RPN const & labels, Proofnumbers const & proofnumbers);
@@ -30,6 +32,9 @@ struct Printer;
 // Subroutine for proof verification. Verify proof steps.
 Expression verify(RPN const & proof, Printer & printer, pAss pass = pAss());
 Expression verify(RPN const & proof, pAss pass = pAss());
+// Verify proof steps, with each NONE step standing for
+// the next of the statements already proved.
+Expression verify(RPN const & proof, pExpressions const & subconclusions);
 
 // Verify a regular proof. The "proof" argument should be a non-empty sequence
 // of valid labels. Return the statement the "proof" proves.
@@ -42,5 +47,7 @@ Expression verify(RPN const & proof, pAss pass = pAss());
 bool checkconclusion
     (strview label,
      Expression const & conclusion, Expression const & expression);
+// Return if the proof of an assertion proves its statement.
+bool checkconclusion(RPN const & proof, pAss pass);
 
 #endif // VERIFY_H_INCLUDED
@@ -1,4 +1,5 @@
 #include <algorithm>    // for std::find
+#include <sstream>
 #include "ass.h"
 #include "database.h"
 #include "io.h"
@@ -11,6 +12,7 @@
 #include "util/arith.h"
 #include "util/find.h"
 #include "util/msg.h"
+#include "util/thread.h"
 #include "bank.h"
 
 std::ostream & operator<<(std::ostream & out, Propctor const & propctor)
@@ -56,6 +58,7 @@ Propctors::Propctors(class Database const & database)
         (database.relations(maskpatterns[i][0], maskpatterns[i][1]), tts[i]);
     
     adddefs(database.definitions());
+    index(database.assertions());
 }
 
 // Return true the data of a propositional syntax constructor is okay.
@@ -276,12 +279,11 @@ int Propctors::calcbool
 // Add lit <-> atom (in the positive sense) to CNF.
 static void addlitatomequiv(CNFClauses & cnf, Literal lit, Atom atom)
 {
-    CNFClauses::size_type const n = cnf.size();
-    cnf.resize(n + 2);
 //std::cout << "Single literal CNF (" << lit << '<->' << atom << ") added\n";
-    cnf[n].resize(2),           cnf[n + 1].resize(2);
-    cnf[n][0] = lit,            cnf[n][1] = 2 * atom + 1;
-    cnf[n + 1][0] = lit ^ 1,    cnf[n + 1][1] = 2 * atom;
+    Literal const clause1[] = {lit, 2 * atom + 1};
+    Literal const clause2[] = {lit ^ 1, 2 * atom};
+    cnf.push_back(clause1, clause1 + 2);
+    cnf.push_back(clause2, clause2 + 2);
 //std::cout << cnf;
 }
 
@@ -295,6 +297,10 @@ bool Propctors::addformula
         return false;
 
     std::vector<Literal> literals(rpn.size());
+    // Map: (connective, literals of arguments) -> literal of subformula,
+    // so that equal subformulas share one auxiliary atom
+    typedef std::pair<strview, std::vector<Literal> > Subformula;
+    std::map<Subformula, Literal> subformulas;
     for (RPNsize i = 0; i < rpn.size(); ++i)
     {
         const char * step = rpn[i];
@@ -318,22 +324,96 @@ bool Propctors::addformula
         }
 //std::cout << "operator ";
         // connective
-        const_iterator const iter = find(step);
-        if (unexpected(iter == end(), "connective", step))
+        const_pointer const iter = findass(rpn[i].pass);
+        if (unexpected(!iter, "connective", step))
             return false;
         // Its arguments
-        std::vector<Literal> args(ast[i].size());
+        Subformula subformula(iter->first, std::vector<Literal>(ast[i].size()));
+        std::vector<Literal> & args = subformula.second;
         for (ASTnode::size_type j = 0; j < args.size(); ++j)
             args[j] = literals[ast[i][j]];
-        // Add the CNF.
-        cnf.append(iter->second.cnf, natom, args.data(), args.size());
-        literals[i] = natom++ * 2;
+        // Reuse the atom of an equal subformula.
+        std::pair<std::map<Subformula, Literal>::iterator, bool> const
+            result(subformulas.insert(std::make_pair(subformula, natom * 2)));
+        literals[i] = result.first->second;
+        if (!result.second)
+            continue;
+        // Add the CNF. The root is never equal to a subformula,
+        // so its atom is the last one.
+        cnf.append(iter->second.cnf, natom++, args.data(), args.size());
 //std::cout << literals[i] / 2 << std::endl;
     }
 //std::cout << "New CNF:\n" << cnf;
     return true;
 }
 
+// Evaluate the fingerprint of a formula, given those of variables by id.
+// Return true if okay. stack is for scratch.
+bool Propctors::fingerprint
+    (RPNspan rpn, Fingerprints const & varfps,
+     Fingerprints & stack, Fingerprint & result) const
+{
+    stack.clear();
+    for (RPNiter iter = rpn.first; iter != rpn.second; ++iter)
+    {
+        if (Symbol2::ID const id = iter->id())
+        {
+            if (id >= varfps.size())
+                return false;
+            stack.push_back(varfps[id]);
+            continue;
+        }
+        // connective
+        const_pointer const ctor = findass(iter->pass);
+        if (!ctor || ctor->second.nargs > stack.size())
+            return false;
+        // Its arguments
+        Fingerprints::size_type const argpos = stack.size() - ctor->second.nargs;
+        Fingerprint const value = ctor->second(stack.data() + argpos);
+        stack.resize(argpos);
+        stack.push_back(value);
+    }
+    if (stack.size() != 1)
+        return false;
+    result = stack[0];
+    return true;
+}
+
+// Evaluate the BDD of a formula, with variables as atoms by id.
+// Return true if okay. stack is for scratch.
+bool Propctors::bdd
+    (RPNspan rpn, BDDs & bdds, BDDs::Refs & stack, BDDs::Ref & result) const
+{
+    stack.clear();
+    for (RPNiter iter = rpn.first; iter != rpn.second; ++iter)
+    {
+        if (Symbol2::ID const id = iter->id())
+        {
+            stack.push_back(bdds.var(id));
+            if (stack.back() == BDDs::none())
+                return false; // Node limit reached
+            continue;
+        }
+        // connective
+        const_pointer const ctor = findass(iter->pass);
+        if (!ctor || ctor->second.nargs > stack.size())
+            return false;
+        Propctor const & propctor = ctor->second;
+        // Its arguments
+        BDDs::Refs::size_type const argpos = stack.size() - propctor.nargs;
+        BDDs::Ref const value = bdds.apply
+            (propctor.truthtable, stack.data() + argpos, propctor.nargs);
+        if (value == BDDs::none())
+            return false; // Node limit reached
+        stack.resize(argpos);
+        stack.push_back(value);
+    }
+    if (stack.size() != 1)
+        return false;
+    result = stack[0];
+    return true;
+}
+
 // Translate the hypotheses of a propositional assertion to the CNF of an SAT.
 HypsCNF Propctors::hypscnf(Assertion const & ass, Atom & natom,
                            Bvector const & hypstotrim) const
@@ -386,29 +466,64 @@ nAss Propctors::markassertions
     return n;
 }
 
+// Checker of the soundness of propositional assertions, run in parallel
+struct Propchecker
+{
+    Propctors const & propctors;
+    std::vector<Assiter> const & iters;
+    // okay[i] = assertion i is sound
+    std::vector<char> & okay;
+    // errors[i] = error messages of the check of assertion i
+    std::vector<std::string> & errors;
+    Propchecker(Propctors const & propctors,
+                std::vector<Assiter> const & iters, std::vector<char> & okay,
+                std::vector<std::string> & errors) :
+        propctors(propctors), iters(iters), okay(okay), errors(errors) {}
+    // Check assertion i.
+    void operator()(std::size_t i) const
+    {
+        // Collect the error messages, to be printed after joining.
+        std::ostringstream out;
+        Errorsto const errorsto(out);
+        if (!(okay[i] = propctors.checkpropsat(iters[i]->second)))
+            errors[i] = out.str();
+    }
+};
+
 // Return true if all propositional assertions are sound.
+// Report the first unsound one in file order.
 bool Propctors::checkpropsat(Assertions const & assertions,
                              struct Typecodes const & typecodes) const
 {
-    FOR (Assertions::const_reference rass, assertions)
+    // Propositional assertions, in the order of a serial check
+    std::vector<Assiter> iters;
+    for (Assiter iter = assertions.begin(); iter != assertions.end(); ++iter)
     {
-        Assertion const & ass = rass.second;
+        Assertion const & ass = iter->second;
         if (ass.expression.empty())
             return false;
         if (typecodes.isprimitive(ass.exptypecode()) != FALSE)
             continue; // Skip syntax axioms.
         if (!ass.testtype(Asstype::PROPOSITIONAL))
             continue; // Skip non propositional assertions.
-
-        if (!checkpropsat(ass))
-        {
-            printass(rass);
-            std::cerr << "Logic error!" << std::endl;
-            return false;
-        }
+        iters.push_back(iter);
     }
 
-    return true;
+    // One SAT instance per assertion
+    std::vector<char> okay(iters.size(), true);
+    std::vector<std::string> errors(iters.size());
+    Propchecker checker(*this, iters, okay, errors);
+    util::parallel_for(iters.size(), checker);
+
+    std::vector<char>::const_iterator const iter
+        = std::find(okay.begin(), okay.end(), false);
+    if (iter == okay.end())
+        return true;
+    std::vector<Assiter>::size_type const i = iter - okay.begin();
+    std::cerr << errors[i];
+    printass(*iters[i]);
+    std::cerr << "Logic error!" << std::endl;
+    return false;
 }
 
 // Return true if the root of an RPN is propositional,
@@ -4,6 +4,8 @@
 #include <iosfwd>
 #include "CNF.h"
 #include "def.h"
+#include "fingerprint.h"
+#include "satsolve/BDD.h"
 #include "util/for.h"
 
 // Propositional syntax constructor
@@ -15,12 +17,27 @@ struct Propctor: Definition
     CNFClauses cnf;
     // # arguments of the propositional connective
     Atom nargs;
+    // Fingerprint of the connective applied to arguments
+    Fingerprint operator()(Fingerprint const * args) const
+    {
+        Fingerprint result;
+        for (TTindex row = 0; row < truthtable.size(); ++row)
+        {
+            if (!truthtable[row])
+                continue;
+            Fingerprint minterm(~Fingerprint());
+            for (Atom i = 0; i < nargs; ++i)
+                minterm &= row >> i & 1 ? args[i] : ~args[i];
+            result |= minterm;
+        }
+        return result;
+    }
 };
 
 std::ostream & operator<<(std::ostream & out, Propctor const & propctor);
 
 // Map: propositional syntax constructor label -> data
-struct Propctors : std::map<strview, Propctor>
+struct Propctors : Assmap<Propctor>
 {
     Propctors() {}
     Propctors(class Database const & database);
@@ -52,6 +69,15 @@ struct Propctors : std::map<strview, Propctor>
     bool addformula
         (RPN const & rpn, AST const & ast, Hypiters const & hyps,
          CNFClauses & cnf, Atom & natom) const;
+// Evaluate the fingerprint of a formula, given those of variables by id.
+// Return true if okay. stack is for scratch.
+    bool fingerprint
+        (RPNspan rpn, Fingerprints const & varfps,
+         Fingerprints & stack, Fingerprint & result) const;
+// Evaluate the BDD of a formula, with variables as atoms by id.
+// Return true if okay. stack is for scratch.
+    bool bdd(RPNspan rpn, BDDs & bdds,
+             BDDs::Refs & stack, BDDs::Ref & result) const;
 // Translate the hypotheses of a propositional assertion to the CNF of an SAT.
     HypsCNF hypscnf(Assertion const & ass, Atom & natom,
                     Bvector const & hypstotrim = Bvector()) const;
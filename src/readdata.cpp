@@ -1,5 +1,6 @@
-#include <algorithm>    // for std::lower_bound
+#include <algorithm>    // for std::lower_bound and std::find
 #include <iostream>
+#include <sstream>
 #include "database.h"
 #include "getproof.h"
 #include "io.h"
@@ -7,6 +8,7 @@
 #include "scope.h"
 #include "util/filter.h"
 #include "util/progress.h"
+#include "util/thread.h"
 
 namespace {
 class Imp
@@ -15,6 +17,8 @@ class Imp
     Database & m_database;
     Scopes m_scopes;
     Tokens & m_tokens;
+    // Verify proofs or just read them
+    bool const m_verify;
 private:
 // Read rest of expression after its type.
 // Discard tokens up to and including the terminator.
@@ -68,9 +72,10 @@ private:
 // Read $v statement. Return true if okay.
     bool readv();
 public:
-    Imp(Database & database, Tokens & tokens, Comments const & comments) :
-        m_comments(comments), m_database(database), m_scopes(), m_tokens(tokens)
-        {}
+    Imp(Database & database, Tokens & tokens, Comments const & comments,
+        bool verify) :
+        m_comments(comments), m_database(database), m_scopes(),
+        m_tokens(tokens), m_verify(verify) {}
 // Read tokens. Returns true if okay.
     bool read(Tokens::size_type const upto);
 };
@@ -147,10 +152,15 @@ Assertions::iterator Database::addass
     Assertions::iterator const iter = m_assertions.insert(value).first;
     Assertion & ass = iter->second;
     ass.expression = exp;
+    ass.codes = codes(exp);
     scopes.completeass(ass);
     ass.number = assertions().size();
     ass.tokenpos = tokenpos;
     m_assiters.push_back(iter);
+    util::Interner::ID const id = m_symbols.add(label);
+    if (id >= m_assbyid.size())
+        m_assbyid.resize(id + 1);
+    m_assbyid[id] = &*iter;
     return iter;
 }
 
@@ -171,7 +181,7 @@ static unsigned discouragement
     // First comment after from
     Comments::const_iterator iter =
         std::lower_bound(comments.begin(), comments.end(), from);
-    for ( ; iter->tokenpos < to; ++iter)
+    for ( ; iter != comments.end() && iter->tokenpos < to; ++iter)
         result |= discouragement(iter->text);
 //std::cout << " with result " << result;
     return result;
@@ -216,9 +226,8 @@ void Imp::addasstype(Assertion & ass, bool isaxiom) const
 RPNstep Imp::getRPNstep(strview label)
 {
     // Check if token names an assertion.
-    Assiter const iterass = m_database.assertions().find(label);
-    return iterass != m_database.assertions().end() ? RPNstep(&*iterass) :
-        RPNstep(m_scopes.activehypptr(label));
+    pAss const pass = m_database.findass(label);
+    return pass ? RPNstep(pass) : RPNstep(m_scopes.activehypptr(label));
 }
 
 // Read the labels of a compressed proof.
@@ -392,9 +401,12 @@ bool Imp::readp(strview label)
     if (okay != ReadStatus::PROOFOKAY)
         return okay == ReadStatus::INCOMPLETE;
 
+    // Proofs already verified
+    if (!m_verify)
+        return ass.proof = proof, true;
+
     // Verify proof steps
-    Expression const & exp(verify(proof, &*iterass));
-    okay = checkconclusion(label, exp, ass.expression);
+    okay = checkconclusion(proof, &*iterass);
     if (okay)
         ass.proof = proof;
 
@@ -702,13 +714,59 @@ bool Imp::read(Tokens::size_type const upto)
 
     return m_scopes.isouter("${ without corresponding $}");
 }
+// Verifier of the proofs of theorems, run in parallel
+struct Verifier
+{
+    Assiters const & assiters;
+    // okay[i] = proof of assertion i is okay
+    std::vector<char> & okay;
+    // errors[i] = error messages of the proof of assertion i
+    std::vector<std::string> & errors;
+    Verifier(Assiters const & assiters, std::vector<char> & okay,
+             std::vector<std::string> & errors) :
+        assiters(assiters), okay(okay), errors(errors) {}
+    // Verify the proof of assertion i, if any. Assertions start from 1.
+    void operator()(std::size_t i) const
+    {
+        if (i == 0)
+            return;
+        Assiter const iter = assiters[i];
+        Assertion const & ass = iter->second;
+        if (ass.proof.empty())
+            return; // Axiom or incomplete proof
+        // Collect the error messages, to be printed after joining.
+        std::ostringstream out;
+        Errorsto const errorsto(out);
+        if (!(okay[i] = checkconclusion(ass.proof, &*iter)))
+            errors[i] = out.str();
+    }
+};
+
+// Verify the proofs of all theorems on all threads.
+// Report the first error in file order. Return true if okay.
+static bool verifyall(Assiters const & assiters)
+{
+    std::vector<char> okay(assiters.size(), true);
+    std::vector<std::string> errors(assiters.size());
+    Verifier verifier(assiters, okay, errors);
+    util::parallel_for(assiters.size(), verifier);
+
+    std::vector<char>::const_iterator const iter
+        = std::find(okay.begin(), okay.end(), false);
+    if (iter == okay.end())
+        return true;
+    std::cerr << errors[iter - okay.begin()];
+    return false;
+}
 } // anonymous namespace
 
 // Read data from tokens. Returns true if okay.
 bool Database::read(Tokens & tokens, Comments const & comments,
-                    Tokens::size_type const upto)
+                    Tokens::size_type const upto, bool verifyproofs)
 {
     clear();
+    // Labels are looked up by their IDs among the tokens.
+    m_symbols = tokens.symbols;
 
 // Additional information comments ($4.4.3)
     m_commentinfo = Commentinfo(comments["$j"]);
@@ -716,6 +774,14 @@ bool Database::read(Tokens & tokens, Comments const & comments,
     bool checkassiters
         (Assertions const & assertions, Assiters const & assiters);
 
-    return Imp(*this, tokens, comments).read(upto)
-        && checkassiters(assertions(), assiters());
+    // Verify proofs inline on a single thread, or after reading on more.
+    bool const parallel = verifyproofs && util::nthreads() > 1;
+    bool const okay =
+        Imp(*this, tokens, comments, verifyproofs && !parallel).read(upto);
+    // Proofs read so far are verified even if reading fails,
+    // so that no error in them goes unreported.
+    if (parallel && !verifyall(assiters()))
+        return false;
+
+    return okay && checkassiters(assertions(), assiters());
 }
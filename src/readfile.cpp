@@ -1,50 +1,105 @@
-#include <algorithm>
+#include <algorithm>    // for std::find and std::max
 #include <cctype>       // for std::isprint
 #include <fstream>
 #include <iostream>
-#include <locale>
+#include <iterator>     // for std::istreambuf_iterator
 #include <set>
 #include <vector>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>      // for open
+#include <sys/mman.h>   // for mmap
+#include <sys/stat.h>   // for fstat
+#include <unistd.h>     // for close and sysconf
+#endif // _WIN32
 #include "comment.h"
 #include "util/msg.h"
+#include "sect.h"       // for isheader
 #include "token.h"
 #include "util/find.h"
 #include "util/for.h"   // for util::end
+#include "util/hash.h"
+#include "util/thread.h"
 
-// Return true iff ch is not printable ($4.1.1).
-static bool notprint(unsigned char ch)
+// Classes of characters ($4.1.1)
+enum Charclass { BADCHAR, WHITESPACE, TOKENCHAR };
+
+// Table: char -> its class
+struct Charclasses
 {
-    return !std::isprint(ch);
-}
+    unsigned char table[256];
+    Charclasses()
+    {
+        for (int c = 0; c < 256; ++c)
+            table[c] = std::isprint(c) ? TOKENCHAR : BADCHAR;
+        // '\v' (vertical tab) is not a white space per spec ($4.1.1)
+        for (const char * s = mmws; *s; ++s)
+            table[static_cast<unsigned char>(*s)] = WHITESPACE;
+    }
+    unsigned char operator[](char c) const
+    { return table[static_cast<unsigned char>(c)]; }
+};
+static Charclasses const charclasses;
 
-// Return the next token ($4.1.1).
-static Token nexttoken(std::istream & in)
+// Position in a file buffer being scanned
+struct Scanner
 {
-    if (!in.good())
-        return Token();
+    char * pos;
+    char * const end;
+    Scanner(char * begin, char * end) : pos(begin), end(end) {}
+};
 
-    Token token;
-    in >> token;
+// Scan the next token ($4.1.1) and return its length.
+// Return 0 at the end or on invalid characters, which in.pos then points to.
+static std::size_t scantoken(Scanner & in)
+{
+    while (in.pos != in.end && charclasses[*in.pos] == WHITESPACE)
+        ++in.pos;
 
-    // Iterator to first invalid character ($4.1.1)
-    Token::const_iterator const iter
-        (std::find_if(token.begin(), token.end(), notprint));
-    if (iter != token.end())
-    {
-        std::cerr << "Invalid character read with code 0x";
-        std::cerr << std::hex << (unsigned int)(unsigned char)*iter;
-        std::cerr << std::dec << std::endl;
-        return Token();
-    }
+    char * const begin = in.pos;
+    while (in.pos != in.end && charclasses[*in.pos] == TOKENCHAR)
+        ++in.pos;
+
+    if (in.pos != in.end && charclasses[*in.pos] == BADCHAR)
+        return 0;
+
+    return in.pos - begin;
+}
+
+// Show error message for an invalid character ($4.1.1).
+static void badcharerr(char c)
+{
+    std::cerr << "Invalid character read with code 0x";
+    std::cerr << std::hex << (unsigned int)(unsigned char)c;
+    std::cerr << std::dec << std::endl;
+}
+
+// Null-terminate the token just scanned, and return it.
+static const char * endtoken(Scanner & in, std::size_t len)
+{
+    char * const token = in.pos - len;
+    // The char after the token is a white space or the final null char.
+    if (in.pos != in.end)
+        *in.pos++ = '\0';
     return token;
 }
 
+// Return the next token ($4.1.1), or "" at the end or on failure.
+static strview nexttoken(Scanner & in)
+{
+    std::size_t const len = scantoken(in);
+    if (len == 0 && in.pos != in.end)
+        badcharerr(*in.pos);
+    return len ? endtoken(in, len) : "";
+}
+
 typedef std::string Filename;
 typedef std::set<Filename> Filenames;
 
 // Read file name in file inclusion commands ($4.1.2).
 // Return the file name if okay; otherwise return the empty string.
-static Filename readfilename(std::ifstream & in)
+static Filename readfilename(Scanner & in)
 {
     Filename const name(nexttoken(in));
     if (name.find('$') < Filename::npos)
@@ -53,8 +108,7 @@ static Filename readfilename(std::ifstream & in)
         return Filename();
     }
 
-    Token const token(nexttoken(in));
-    if (token != "$]")
+    if (nexttoken(in) != "$]")
     {
         std::cerr << "Didn't find closing file inclusion delimiter"
                   << std::endl;
@@ -64,113 +118,253 @@ static Filename readfilename(std::ifstream & in)
     return name;
 }
 
-// Prepare stream for I/O, switching the whitespace states of some chars.
-static void preparestream(std::ios_base & ios, const char * chars)
-{
-    // Get the classic character classifying table
-    typedef std::ctype<char> ctype;
-    static const ctype::mask * const table(ctype::classic_table());
-
-    // Duplicate it
-    static const std::size_t size(ctype::table_size);
-    static std::vector<ctype::mask> masks(table, table + size);
-    static ctype::mask * const data(masks.data());
-
-    std::size_t c;
-    for (c = *chars; c; c = *++chars)
-        masks[c] = table[c] ^ ctype::space;
-
-    // Set the new character classifying table
-    ios.imbue(std::locale(std::locale::classic(), new ctype(data)));
-}
-
 // Show error message when reading named file.
 static void file_err(const char * msg, const char * name)
 {
     std::cerr << msg << ' ' << name << std::endl;
 }
 
-// Associate the file stream with named file. Returns true if okay.
-static bool openfile(std::ifstream & in, const char * name)
+// File buffer read by a stream
+struct Streambuffer : Filebuffer
 {
-    // '\v' (vertical tab) is not a white space per spec ($4.1.1)
-    preparestream(in, "\v");
-    in.open(name);
-    return static_cast<bool>(in);
-}
+    std::vector<char> text;
+    // Read the whole file. Return true if okay.
+    bool read(const char * name)
+    {
+        std::ifstream in(name, std::ios::binary);
+        if (!in)
+            return false;
+        text.assign(std::istreambuf_iterator<char>(in),
+                    std::istreambuf_iterator<char>());
+        if (in.bad())
+            return false;
+        text.push_back('\0');
+        begin = &text[0];
+        end = begin + text.size() - 1;
+        return true;
+    }
+};
 
-// Read tokens. Returns true if okay.
-static bool readtokens
-    (const char * const name, Filenames & names,
-     Tokens & tokens, Comments & comments)
+// File buffer mapped copy-on-write into memory
+struct Mappedbuffer : Filebuffer
 {
-    if (!names.insert(name).second)
-        return true; // file already read
-
-    std::ifstream in;
-    if (!openfile(in, name))
+#ifdef _WIN32
+    HANDLE file, mapping;
+    Mappedbuffer() : file(INVALID_HANDLE_VALUE), mapping(NULL) {}
+    ~Mappedbuffer()
     {
-        file_err("Could not open", name);
-        return false;
+        if (begin) UnmapViewOfFile(begin);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
     }
+    // Map the file. Return true if okay.
+    // The file size should not be a multiple of the page size,
+    // so that the rest of the last page provides the final null char.
+    bool map(const char * name)
+    {
+        file = CreateFileA(name, GENERIC_READ, FILE_SHARE_READ, NULL,
+                           OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+        LARGE_INTEGER size;
+        if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &size))
+            return false;
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        if (size.QuadPart % info.dwPageSize == 0 ||
+            size.QuadPart != static_cast<SIZE_T>(size.QuadPart))
+            return false;
+        mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+        if (!mapping)
+            return false;
+        begin = static_cast<char *>(MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0));
+        if (!begin)
+            return false;
+        end = begin + size.QuadPart;
+        return true;
+    }
+#else
+    std::size_t size;
+    Mappedbuffer() : size(0) {}
+    ~Mappedbuffer() { if (begin) munmap(begin, size); }
+    // Map the file. Return true if okay.
+    // The file size should not be a multiple of the page size,
+    // so that the rest of the last page provides the final null char.
+    bool map(const char * name)
+    {
+        int const fd = open(name, O_RDONLY);
+        if (fd < 0)
+            return false;
+        struct stat st;
+        long const pagesize = sysconf(_SC_PAGESIZE);
+        if (fstat(fd, &st) != 0 || pagesize <= 0 ||
+            st.st_size % pagesize == 0 ||
+            st.st_size != static_cast<off_t>(static_cast<std::size_t>(st.st_size)))
+            return close(fd), false;
+        size = st.st_size;
+        void * const p = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                              MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (p == MAP_FAILED)
+            return false;
+        begin = static_cast<char *>(p);
+        end = begin + size;
+        return true;
+    }
+#endif // _WIN32
+};
 
-    bool instatement = false;
-    std::size_t nscopes = 0;
+// Open the named file, mapping it if possible. Return NULL on failure.
+static Filebuffer * openfile(const char * name)
+{
+    Mappedbuffer * const mapped = new Mappedbuffer;
+    if (mapped->map(name))
+        return mapped;
+    delete mapped;
+
+    Streambuffer * const streamed = new Streambuffer;
+    if (streamed->read(name))
+        return streamed;
+    delete streamed;
+
+    return NULL;
+}
 
-    Token token;
-    while (!(token = nexttoken(in)).empty())
+// Text between comments and file inclusion commands,
+// followed by a comment, a file inclusion or the end of the file
+struct Piece
+{
+    char * begin;
+    char * end;
+    // Text of the comment after it, or NULL
+    const char * comment;
+    // Name of the file included after it, or ""
+    Filename include;
+    // Chunks of the text to tokenize, [firstchunk, endchunk)
+    std::size_t firstchunk, endchunk;
+    // Hash of the text, with the comment or file inclusion after it
+    std::size_t hash;
+    Piece(char * begin, char * end) :
+        begin(begin), end(end), comment(NULL), firstchunk(0), endchunk(0),
+        hash(0) {}
+};
+typedef std::vector<Piece> Pieces;
+
+// Split the file into pieces at comments and file inclusions ($4.1.2).
+// Stop after the header of the section whose title begins with section,
+// if it is not NULL. Return true if okay.
+static bool splitfile(Filebuffer const & buffer, Pieces & pieces,
+                      const char * section, bool & stopped)
+{
+    char * pos = buffer.begin;
+    char * const end = buffer.end;
+    char * textbegin = pos;
+
+    while ((pos = std::find(pos, end, '$')) != end)
     {
-//std::cout << token << ' ';
+        char * const dollar = pos++;
+        // Check if "$(" or "$[" is a token by itself.
+        if (pos == end || (*pos != '(' && *pos != '['))
+            continue;
+        if (dollar != textbegin && charclasses[dollar[-1]] != WHITESPACE)
+            continue;
+        if (pos + 1 != end && charclasses[pos[1]] != WHITESPACE)
+            continue;
 
-        if (token == "$(")
+        Piece piece(textbegin, dollar);
+        ++pos;
+        if (dollar[1] == '(')
         {
-            // Read and return a comment. Return "" on failure ($4.1.2).
-            std::string comment(std::ifstream & in);
-            Comment const newcomment = {comment(in), tokens.size()};
-            if (newcomment.text.empty())
+            // Read and return a comment. Return NULL on failure ($4.1.2).
+            const char * comment(char * & pos, char * const end);
+            if (!(piece.comment = comment(pos, end)))
             {
                 std::cerr << "Bad comment" << std::endl;
                 return false;
             }
-
-            comments.push_back(newcomment);
-            continue;
         }
-
-        if (token == "$[")
+        else
         {
-            // File inclusion command only allowed in outermost scope ($4.1.2)
-            if (nscopes > 0)
-            {
-                std::cerr << "File inclusion command not in outermost scope\n";
-                return false;
-            }
-            // File inclusion command cannot be in a statement ($4.1.2)
-            if (instatement)
-            {
-                std::cerr << "File inclusion command in a statement\n";
-                return false;
-            }
-
-            Filename const & newname(readfilename(in));
-            if (newname.empty())
+            Scanner in(pos, end);
+            piece.include = readfilename(in);
+            if (piece.include.empty())
             {
                 std::cerr << "Unfinished file inclusion command" << std::endl;
                 return false;
             }
+            pos = in.pos;
+        }
 
-            if (!readtokens(newname.c_str(), names, tokens, comments))
-            {
-                file_err("Error reading from included", newname.c_str());
-                return false;
-            }
+        // Hash the text before it is tokenized in place.
+        piece.hash = util::Hash().add(textbegin, pos).value();
+        pieces.push_back(piece);
+        textbegin = pos;
 
-            continue;
+        // Text after the section is never tokenized.
+        if (section && piece.comment && isheader(piece.comment, section))
+            return stopped = true;
+    }
+
+    pieces.push_back(Piece(textbegin, end));
+    pieces.back().hash = util::Hash().add(textbegin, end).value();
+    return true;
+}
+
+// Chunk of text, and the tokens in it
+struct Chunk
+{
+    char * begin;
+    char * end;
+    std::vector<strview> tokens;
+    // Invalid character found, or NULL
+    const char * badchar;
+    Chunk(char * begin, char * end) : begin(begin), end(end), badchar(NULL) {}
+};
+typedef std::vector<Chunk> Chunks;
+
+// Split the text of the pieces into chunks of about a given size,
+// cut after white spaces.
+static void splittext(Pieces & pieces, std::size_t chunksize, Chunks & chunks)
+{
+    FOR (Piece & piece, pieces)
+    {
+        piece.firstchunk = chunks.size();
+        for (char * begin = piece.begin; begin != piece.end; )
+        {
+            std::size_t const size = piece.end - begin;
+            char * cut = size > chunksize ? begin + chunksize : piece.end;
+            while (cut != piece.end && charclasses[*cut++] != WHITESPACE) ;
+            chunks.push_back(Chunk(begin, cut));
+            begin = cut;
         }
+        piece.endchunk = chunks.size();
+    }
+}
 
-        // types of statements
-        const char * const statements[] = {"$c", "$v", "$f", "$e", "$d", "$a", "$p"};
+// Tokenizer of chunks, run in parallel
+struct Tokenizer
+{
+    Chunks & chunks;
+    Tokenizer(Chunks & chunks) : chunks(chunks) {}
+    void operator()(std::size_t i)
+    {
+        Chunk & chunk = chunks[i];
+        Scanner in(chunk.begin, chunk.end);
+        while (std::size_t const len = scantoken(in))
+            chunk.tokens.push_back(endtoken(in, len));
+        if (in.pos != in.end)
+            chunk.badchar = in.pos;
+    }
+};
+
+// Add a token, keeping track of scopes and statements.
+// Return true if okay.
+static bool addtoken(strview token, Tokens & tokens,
+                     std::size_t & nscopes, bool & instatement)
+{
+    // types of statements
+    const char * const statements[] = {"$c", "$v", "$f", "$e", "$d", "$a", "$p"};
 
+    if (token.c_str[0] == '$')
+    {
         // Count scopes
         if (token == "${")
             ++nscopes;
@@ -189,24 +383,111 @@ static bool readtokens
             instatement = true;
         else if (token == "$.")
             instatement = false;
-
-        tokens.push_back(token);
     }
 
-    if (!in.eof())
+    tokens.push_back(tokens.symbols.intern(token));
+    return true;
+}
+
+// Read tokens, tokenizing on up to nthreads threads.
+// Stop after the header of the section whose title begins with section,
+// if it is not NULL. Returns true if okay.
+static bool readtokens
+    (const char * const name, Filenames & names,
+     Tokens & tokens, Comments & comments, unsigned nthreads,
+     const char * section, bool & stopped)
+{
+    if (!names.insert(name).second)
+        return true; // file already read
+
+    Filebuffer * const buffer = openfile(name);
+    if (!buffer)
     {
-        if (in.fail())
-            file_err("Error reading from", name);
+        file_err("Could not open", name);
         return false;
     }
+    tokens.addbuffer(buffer);
+
+    // Find comments and file inclusions.
+    Pieces pieces;
+    bool stopsinfile = false;
+    if (!splitfile(*buffer, pieces, section, stopsinfile))
+        return false;
+
+    // Tokenize the text in between in chunks.
+    static const std::size_t minchunksize = 1 << 16;
+    std::size_t const size = buffer->end - buffer->begin;
+    std::size_t const chunksize = std::max(size / (4 * nthreads), minchunksize);
+    Chunks chunks;
+    splittext(pieces, chunksize, chunks);
+    Tokenizer tokenizer(chunks);
+    util::parallel_for(chunks.size(), tokenizer, nthreads);
+
+    // Stitch the tokens together in order.
+    bool instatement = false;
+    std::size_t nscopes = 0;
+
+    FOR (Piece const & piece, pieces)
+    {
+        // Only the text actually read goes into the hash.
+        tokens.hash.add(piece.hash);
+        for (std::size_t i = piece.firstchunk; i < piece.endchunk; ++i)
+        {
+            FOR (strview token, chunks[i].tokens)
+                if (!addtoken(token, tokens, nscopes, instatement))
+                    return false;
+            if (chunks[i].badchar)
+            {
+                badcharerr(*chunks[i].badchar);
+                return false;
+            }
+        }
+
+        if (piece.comment)
+        {
+            Comment const newcomment = {piece.comment, tokens.size()};
+            comments.push_back(newcomment);
+        }
+        else if (!piece.include.empty())
+        {
+            // File inclusion command only allowed in outermost scope ($4.1.2)
+            if (nscopes > 0)
+            {
+                std::cerr << "File inclusion command not in outermost scope\n";
+                return false;
+            }
+            // File inclusion command cannot be in a statement ($4.1.2)
+            if (instatement)
+            {
+                std::cerr << "File inclusion command in a statement\n";
+                return false;
+            }
+
+            char const * const newname = piece.include.c_str();
+            if (!readtokens(newname, names, tokens, comments, nthreads,
+                            section, stopped))
+            {
+                file_err("Error reading from included", newname);
+                return false;
+            }
+            if (stopped)
+                return true;
+        }
+    }
 
+    stopped = stopsinfile;
     return true;
 }
 
-// Read tokens. Returns true if okay.
+// Read tokens, tokenizing on up to nthreads threads.
+// Stop after the header of the section whose title begins with section,
+// if it is not NULL. Returns true if okay.
 bool doread(const char * name,
-            struct Tokens & tokens, struct Comments & comments)
+            struct Tokens & tokens, struct Comments & comments,
+            unsigned nthreads, const char * section)
 {
     Filenames names;
-    return readtokens(name, names, tokens, comments);
+    bool stopped = false;
+    return readtokens(name, names, tokens, comments, std::max(nthreads, 1u),
+                      section, stopped);
 }
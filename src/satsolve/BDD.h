@@ -0,0 +1,180 @@
+#ifndef BDD_H_INCLUDED
+#define BDD_H_INCLUDED
+
+#include <algorithm>// for std::min and std::swap
+#include <cstddef>  // for std::size_t
+#include <vector>
+#include "../CNF.h"
+
+// Reduced ordered binary decision diagrams with complement edges.
+// Equal functions share one node through the unique table,
+// so equivalence is equality of edges.
+// Once the node limit is reached, operations needing a new node fail
+// and return none().
+class BDDs
+{
+public:
+    // Edge to a node: node index * 2 + complemented
+    typedef unsigned Ref;
+    typedef std::vector<Ref> Refs;
+    // Constant functions, as edges to the terminal node
+    static Ref top() { return 0; }
+    static Ref bottom() { return 1; }
+    // No function, returned when the node limit is reached
+    static Ref none() { return static_cast<Ref>(-1); }
+    // The tables are allocated on first use.
+    BDDs(std::size_t maxnodes = 1 << 20) : id(newid()),
+        m_nodes(1, Node(TERMINAL, top(), top())), m_maxnodes(maxnodes) {}
+    // Unique id of the BDDs, starting from 1
+    std::size_t const id;
+    // # nodes, including the terminal
+    std::size_t size() const { return m_nodes.size(); }
+    // Function of an atom
+    Ref var(Atom atom) { return node(atom, bottom(), top()); }
+    // If f then g else h
+    Ref ite(Ref f, Ref g, Ref h)
+    {
+        if (f == none() || g == none() || h == none()) return none();
+        // Terminal cases
+        if (f == top()) return g;
+        if (f == bottom()) return h;
+        // Simplify the branches against the condition.
+        if (g == f) g = top(); else if (g == (f ^ 1)) g = bottom();
+        if (h == f) h = bottom(); else if (h == (f ^ 1)) h = top();
+        if (g == h) return g;
+        if (g == top() && h == bottom()) return f;
+        if (g == bottom() && h == top()) return f ^ 1;
+        // Normalize: regular condition and then-branch.
+        if (f & 1) std::swap(g, h), f ^= 1;
+        Ref const neg = g & 1;
+        g ^= neg, h ^= neg;
+        // Computed table
+        if (m_cache.empty())
+            m_cache.resize(1 << 14);
+        Cacheentry & entry = m_cache[hash(f, g, h) & (m_cache.size() - 1)];
+        if (entry.f == f && entry.g == g && entry.h == h)
+            return entry.result ^ neg;
+        // Shannon expansion on the top atom
+        Atom const atom
+            = std::min(topatom(f), std::min(topatom(g), topatom(h)));
+        Ref const high = ite(cofactor(f, atom, true), cofactor(g, atom, true),
+                             cofactor(h, atom, true));
+        Ref const low = ite(cofactor(f, atom, false),
+                            cofactor(g, atom, false), cofactor(h, atom, false));
+        Ref const result = node(atom, low, high);
+        if (result == none())
+            return none();
+        Cacheentry const newentry = {f, g, h, result};
+        entry = newentry;
+        return result ^ neg;
+    }
+    // f and g
+    Ref conj(Ref f, Ref g) { return ite(f, g, bottom()); }
+    // Return TRUE if f => g, FALSE if not, UNKNOWN if the node limit is hit.
+    Tribool implies(Ref f, Ref g)
+    {
+        Ref const result = ite(f, g, top());
+        return result == none() ? UNKNOWN : result == top() ? TRUE : FALSE;
+    }
+    // Function of a connective with a truth table, applied to arguments.
+    // Bit i of the row of the truth table is the value of argument i.
+    Ref apply(Bvector const & truthtable, Ref const args[], Atom nargs)
+    { return apply(truthtable, 0, args, nargs); }
+private:
+    // Atom of the terminal node, after all atoms
+    static const Atom TERMINAL = static_cast<Atom>(-1);
+    struct Node
+    {
+        Atom atom;
+        // Edges when the atom is false/true. High edges are regular.
+        Ref low, high;
+        Node(Atom atom, Ref low, Ref high) :
+            atom(atom), low(low), high(high) {}
+    };
+    struct Cacheentry { Ref f, g, h, result; };
+    // m_nodes[i] = node i
+    std::vector<Node> m_nodes;
+    // Open-addressing unique table: slot -> node index, 0 if empty
+    std::vector<Ref> m_slots;
+    // Direct-mapped computed table of ite
+    std::vector<Cacheentry> m_cache;
+    std::size_t const m_maxnodes;
+    static std::size_t newid() { static std::size_t n = 0; return ++n; }
+    static std::size_t hash(Ref x, Ref y, Ref z)
+    {
+        std::size_t h = 2166136261u;
+        h = (h ^ x) * 16777619u;
+        h = (h ^ y) * 16777619u;
+        return (h ^ z) * 16777619u;
+    }
+    // Top atom of a function
+    Atom topatom(Ref f) const { return m_nodes[f >> 1].atom; }
+    // Cofactor of a function with an atom no later than its top atom
+    Ref cofactor(Ref f, Atom atom, bool value) const
+    {
+        Node const & n = m_nodes[f >> 1];
+        if (n.atom != atom)
+            return f;
+        return (value ? n.high : n.low) ^ (f & 1);
+    }
+    // Return the slot holding a node, or the empty slot to put it in.
+    std::size_t findslot(Atom atom, Ref low, Ref high) const
+    {
+        std::size_t const mask = m_slots.size() - 1;
+        std::size_t slot = hash(atom, low, high) & mask;
+        for ( ; m_slots[slot]; slot = (slot + 1) & mask)
+        {
+            Node const & n = m_nodes[m_slots[slot]];
+            if (n.atom == atom && n.low == low && n.high == high)
+                break;
+        }
+        return slot;
+    }
+    // Edge to the node (atom ? high : low), shared if already present
+    // Return none() if either edge is none() or the node limit is reached.
+    Ref node(Atom atom, Ref low, Ref high)
+    {
+        if (low == none() || high == none())
+            return none();
+        if (low == high)
+            return low;
+        // Keep the high edge regular.
+        Ref const neg = high & 1;
+        low ^= neg, high ^= neg;
+        if (m_slots.empty())
+            m_slots.resize(1024);
+        std::size_t slot = findslot(atom, low, high);
+        if (m_slots[slot])
+            return m_slots[slot] * 2 ^ neg;
+        if (m_nodes.size() >= m_maxnodes)
+            return none();
+        // Keep the load factor under 1/2.
+        if (2 * m_nodes.size() >= m_slots.size())
+        {
+            std::vector<Ref>(2 * m_slots.size()).swap(m_slots);
+            for (Ref i = 1; i < m_nodes.size(); ++i)
+            {
+                Node const & n = m_nodes[i];
+                m_slots[findslot(n.atom, n.low, n.high)] = i;
+            }
+            slot = findslot(atom, low, high);
+        }
+        m_nodes.push_back(Node(atom, low, high));
+        m_slots[slot] = m_nodes.size() - 1;
+        return m_slots[slot] * 2 ^ neg;
+    }
+    // Function of rows [begin, begin + 2^nargs) of a truth table
+    Ref apply(Bvector const & truthtable, TTindex begin,
+              Ref const args[], Atom nargs)
+    {
+        if (nargs == 0)
+            return truthtable[begin] ? top() : bottom();
+        // Split on the last argument.
+        TTindex const half = static_cast<TTindex>(1) << (nargs - 1);
+        Ref const high = apply(truthtable, begin + half, args, nargs - 1);
+        Ref const low = apply(truthtable, begin, args, nargs - 1);
+        return ite(args[nargs - 1], high, low);
+    }
+};
+
+#endif // BDD_H_INCLUDED
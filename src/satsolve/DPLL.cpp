@@ -22,76 +22,6 @@ using namespace std;
  */
 #define ACT_INC_UPDATE_RATE 1000
 
-/**
- * General type for counting
- */
-typedef std::size_t uint;
-
-/**
- * General type for activity
- */
-typedef double activity;
-
-/**
- * The number of variables of the satisfiability problem.
- */
-Atom numVariables;
-
-/**
- * The number of clauses of the formula of the satisfiability problem.
- */
-sCNF::size_type numClauses;
-
-/**
- * The list of clauses of the problem.
- */
-sCNF scnf;
-
-/**
- * The occurrence list of positive appearances for each value in the clause set.
- */
-vector<vector<sCNFClause* > > positiveClauses;
-
-/**
- * The occurrence list of negative appearances for each value in the clause set.
- */
-vector<vector<sCNFClause* > > negativeClauses;
-
-/**
- * The current model (interpretation) of the problem.
- */
-vector<int> model;
-
-/**
- * The stack that tracks the current execution state (the backtrack stack).
- */
-vector<sLiteral> modelStack;
-
-/**
- * An index indicating which is the next literal from the stack to be propagated.
- */
-uint indexOfNextLiteralToPropagate;
-
-/**
- * The current decision level of the DPLL algorithm.
- */
-uint decisionLevel;
-
-/**
- * The activity (number of conflicts in which appears) for each positive literal.
- */
-vector<activity> positiveLiteralActivity;
-
-/**
- * The activity (number of conflicts in which appears) for each negative literal.
- */
-vector<activity> negativeLiteralActivity;
-
-/**
- * The total number of conflicts found during the DPLL execution.
- */
-uint conflicts;
-
 /**
  * Returns the variable that this literal represents.
  *
@@ -105,7 +35,7 @@ inline Atom var(sLiteral literal) { return std::abs(literal); }
  * @param varcount the number of variables in the CNF formula
  * @param clausecount the number of clauses in the CNF formula
  */
-void initClauseAppearances(Atom varcount, sCNF::size_type clausecount) {
+void DPLL_solver::initClauseAppearances(Atom varcount, uint clausecount) {
     if (varcount >= positiveClauses.size())
         positiveClauses.resize(varcount + 1);
     if (varcount >= negativeClauses.size())
@@ -119,25 +49,25 @@ void initClauseAppearances(Atom varcount, sCNF::size_type clausecount) {
 }
 
 /**
- * Reads the clauses from CNF and builds the positive/negative appearance lists.
+ * Reads the clauses from a CNF slice, appends them to the clause set
+ * and builds the positive/negative appearance lists.
  *
- * @param src the source CNF clause set to read
- * @param dest the destination clause array to populate
+ * @param src the source CNF slice to read
  */
-void readClauses(CNFClauses const & src, sCNFClause dest[]) {
-	sCNF::size_type clausecount = src.size();
-    for (sCNF::size_type clause = 0; clause < clausecount; ++clause) {
-        sCNFClause::size_type size = src[clause].size();
-        dest[clause].resize(size);
-        for (sCNFClause::size_type i = 0; i < size; ++i) {
-            sLiteral literal = dest[clause][i] = sliteral(src[clause][i]);
+void DPLL_solver::readClauses(CNFSlice const & src) {
+    for (uint i = 0; i < src.size(); ++i) {
+        uint const clause = clauseStarts.size() - 1;
+        FOR (Literal const lit, src[i]) {
+            sLiteral literal = sliteral(lit);
+            scnf.push_back(literal);
             // add to the list of positive-negative literals
             if (literal > 0) {
-                positiveClauses[var(literal)].push_back(&dest[clause]);
+                positiveClauses[var(literal)].push_back(clause);
             } else {
-                negativeClauses[var(literal)].push_back(&dest[clause]);
+                negativeClauses[var(literal)].push_back(clause);
             }
         }
+        clauseStarts.push_back(scnf.size());
     }
 }
 
@@ -146,21 +76,19 @@ void readClauses(CNFClauses const & src, sCNFClause dest[]) {
  * any remaining necessary data structures and variables.
  */
 void DPLL_solver::parseInput() {
-    numVariables = cnf2atoms > cnfatoms ? cnf2atoms : cnfatoms;
-	sCNF::size_type cnfsize = cnf.size();
-    numClauses = cnfsize + cnf2.size();
+    numVariables = natoms;
+    numClauses = 0;
+    FOR (CNFSlice const & slice, slices)
+        numClauses += slice.size();
 
     // Initialize clause appearances
     initClauseAppearances(numVariables, numClauses);
 
-    // Prepare spaces for clauses
-    if (numClauses > scnf.size()) {
-        scnf.resize(numClauses);
-    }
-
     // Read clauses
-    readClauses(cnf, &scnf[0]);
-	readClauses(cnf2,&scnf[cnfsize]);
+    scnf.clear();
+    clauseStarts.assign(1, 0);
+    FOR (CNFSlice const & slice, slices)
+        readClauses(slice);
 
 	// std::cout << "Clauses read" << std::endl;
 	// Initialize the remaining necessary variables
@@ -181,7 +109,7 @@ void DPLL_solver::parseInput() {
  *
  * @param literal the literal which value is requested
  */
-int currentValueForLiteral(sLiteral literal) {
+int DPLL_solver::currentValueForLiteral(sLiteral literal) const {
     return literal >= 0 ? model[literal] :
         model[-literal] == UNKNOWN ? UNKNOWN : 1 - model[-literal];
 }
@@ -193,7 +121,7 @@ int currentValueForLiteral(sLiteral literal) {
  *
  * @param literal the literal that will become true after the model update
  */
-void setLiteralToTrue(sLiteral literal) {
+void DPLL_solver::setLiteralToTrue(sLiteral literal) {
 	modelStack.push_back(literal);
 	model[var(literal)] = literal > 0;
 }
@@ -203,7 +131,7 @@ void setLiteralToTrue(sLiteral literal) {
  *
  * @param literal the literal which activity is to be updated
  */
-void updateActivityForLiteral(sLiteral literal) {
+void DPLL_solver::updateActivityForLiteral(sLiteral literal) {
 	//update the activity of the literal (we are not distinguishing between positive
 	// and negative literals here)
 	(literal > 0 ? positiveLiteralActivity : negativeLiteralActivity)
@@ -216,7 +144,7 @@ void updateActivityForLiteral(sLiteral literal) {
  *
  * @param clause the clause which was involved in the most recent conflict
  */
-void updateActivityForConflictingClause(const sCNFClause& clause) {
+void DPLL_solver::updateActivityForConflictingClause(uint clause) {
 	//update the activity increment if necessary (every X conflicts)
 	++conflicts;
 	if ((conflicts % ACT_INC_UPDATE_RATE) == 0) {
@@ -228,8 +156,8 @@ void updateActivityForConflictingClause(const sCNFClause& clause) {
 	}
 
 	//update activity for each literal
-	for (sCNFClause::size_type i = 0; i < clause.size(); ++i) {
-		updateActivityForLiteral(clause[i]);
+	for (uint i = clauseStarts[clause]; i < clauseStarts[clause + 1]; ++i) {
+		updateActivityForLiteral(scnf[i]);
 	}
 }
 
@@ -240,20 +168,20 @@ void updateActivityForConflictingClause(const sCNFClause& clause) {
  *
  * @return true if a conflict was found while performing the propagation; false otherwise
  */
-bool propagateGivesConflict() {
+bool DPLL_solver::propagateGivesConflict() {
 	while (indexOfNextLiteralToPropagate < modelStack.size()) {
 		//retrieve the literal to be propagated and move forward to the next.
 		sLiteral literalToPropagate = modelStack[indexOfNextLiteralToPropagate++];
 
 		//traverse only positive/negative appearances
-		const vector<sCNFClause* >& clausesToPropagate = literalToPropagate>0 ?
+		const vector<uint>& clausesToPropagate = literalToPropagate>0 ?
 				negativeClauses[var(literalToPropagate)] :
 				positiveClauses[var(literalToPropagate)];
 
 		//traverse the clauses
 		for (uint i = 0; i < clausesToPropagate.size(); ++i) {
 			//retrieve the next clause
-			const sCNFClause& clause = *clausesToPropagate[i];
+			uint clause = clausesToPropagate[i];
 
 			//necessary variables initialization
 			bool isSomeLiteralTrue = false;
@@ -261,14 +189,15 @@ bool propagateGivesConflict() {
 			sLiteral lastUndefinedLiteral = 0;
 
 			//traverse the clause
-			for (uint k = 0; !isSomeLiteralTrue && k < clause.size(); ++k) {
-				int value = currentValueForLiteral(clause[k]);
+			for (uint k = clauseStarts[clause];
+                 !isSomeLiteralTrue && k < clauseStarts[clause + 1]; ++k) {
+				int value = currentValueForLiteral(scnf[k]);
 				if (value == TRUE) {
 					isSomeLiteralTrue = true;
 				}
 				else if (value == UNKNOWN) {
 					++undefinedLiterals;
-					lastUndefinedLiteral = clause[k];
+					lastUndefinedLiteral = scnf[k];
 				}
 			}
 			if (!isSomeLiteralTrue && undefinedLiterals == 0) {
@@ -291,7 +220,7 @@ bool propagateGivesConflict() {
 /**
  * Resets the model and model stack to the last decision level.
  */
-void backtrack() {
+void DPLL_solver::backtrack() {
 	sLiteral literal = 0;
 	while (modelStack.back() != DECISION_MARK) { // 0 is the  mark
 		literal = modelStack.back();
@@ -314,7 +243,7 @@ void backtrack() {
  * @return the next variable to be decided within the DPLL procedure or 0 if no
  * variable is currently undefined
  */
-sLiteral getNextDecisionLiteral() {
+sLiteral DPLL_solver::getNextDecisionLiteral() const {
 	activity maximumActivity = 0.0;
 	sLiteral mostActiveVariable = 0; // in case no variable is undefined, it will not be modified
 	for (Atom i = 1; i <= numVariables; ++i) {
@@ -339,7 +268,7 @@ sLiteral getNextDecisionLiteral() {
  * Executes the DPLL (Davis–Putnam–Logemann–Loveland) algorithm, performing a full search
  * for a model (interpretation) which satisfies the formula given as a CNF clause set.
  */
-bool DPLL() {
+bool DPLL_solver::DPLL() {
 	// DPLL algorithm
 	while (true) {
 		while (propagateGivesConflict()) {
@@ -367,12 +296,13 @@ bool DPLL() {
  * model accordingly. If a contradiction is found among these unit clauses,
  * early failure is triggered.
  */
-bool checkUnitClauses() {
-	for (sCNF::size_type i = 0; i < numClauses; ++i) {
-        if (scnf[i].empty())
+bool DPLL_solver::checkUnitClauses() {
+	for (uint i = 0; i < numClauses; ++i) {
+        uint size = clauseStarts[i + 1] - clauseStarts[i];
+        if (size == 0)
             return false;
-		if (scnf[i].size() == 1) {
-			sLiteral literal = scnf[i][0];
+		if (size == 1) {
+			sLiteral literal = scnf[clauseStarts[i]];
 			int value = currentValueForLiteral(literal);
 			if (value == FALSE) {
 				// This condition will only occur if at least a couple of unit clauses
@@ -1,6 +1,7 @@
 #ifndef DPLL_H_INCLUDED
 #define DPLL_H_INCLUDED
 
+#include <vector>
 #include "SAT.h"
 
 // signed literal: P = 1, !P = -1, Q = 2, !Q = -2, ...
@@ -11,39 +12,121 @@ inline sLiteral sliteral(Literal lit)
     sLiteral const atom = static_cast<sLiteral>(lit / 2) + 1;
     return lit % 2 ? -atom : atom;
 }
-// A list of signed literals
-typedef std::vector<sLiteral> sCNFClause;
-// Instance in conjunctive normal form
-typedef std::vector<sCNFClause> sCNF;
+// Signed literals of all clauses, back to back
+typedef std::vector<sLiteral> sCNF;
 
 // The following is from https://github.com/necavit/li-sat-solver
-
-/**
- * Checks for any unit clause and sets the appropriate values in the
- * model accordingly. If a contradiction is found among these unit clauses,
- * early failure is triggered.
- */
-bool checkUnitClauses();
-
-/**
- * Executes the DPLL (Davis�Putnam�Logemann�Loveland) algorithm, performing a full search
- * for a model (interpretation) which satisfies the formula given as a CNF clause set.
- */
-bool DPLL();
+// All state is kept in the solver, so solvers can run on several threads.
 
 class DPLL_solver : public SATsolver
 {
 public:
-    DPLL_solver
-        (CNFClauses const & hyps, CNFClauses const & morehyps = CNFClauses()) :
-        SATsolver(hyps, morehyps) { parseInput(); }
-    bool sat() const { return checkUnitClauses() && DPLL(); }
+    DPLL_solver(CNFSlices const & slices) :
+        SATsolver(slices) { parseInput(); }
+    bool sat() { return checkUnitClauses() && DPLL(); }
 private:
+    /**
+     * General type for counting
+     */
+    typedef std::size_t uint;
+
+    /**
+     * General type for activity
+     */
+    typedef double activity;
+
+    /**
+     * The number of variables of the satisfiability problem.
+     */
+    Atom numVariables;
+
+    /**
+     * The number of clauses of the formula of the satisfiability problem.
+     */
+    uint numClauses;
+
+    /**
+     * The literals of all clauses of the problem, back to back.
+     */
+    sCNF scnf;
+
+    /**
+     * The start of each clause in scnf, followed by the end of the last clause.
+     */
+    std::vector<uint> clauseStarts;
+
+    /**
+     * The occurrence list of positive appearances for each value in the clause set.
+     */
+    std::vector<std::vector<uint> > positiveClauses;
+
+    /**
+     * The occurrence list of negative appearances for each value in the clause set.
+     */
+    std::vector<std::vector<uint> > negativeClauses;
+
+    /**
+     * The current model (interpretation) of the problem.
+     */
+    std::vector<int> model;
+
+    /**
+     * The stack that tracks the current execution state (the backtrack stack).
+     */
+    std::vector<sLiteral> modelStack;
+
+    /**
+     * An index indicating which is the next literal from the stack to be propagated.
+     */
+    uint indexOfNextLiteralToPropagate;
+
+    /**
+     * The current decision level of the DPLL algorithm.
+     */
+    uint decisionLevel;
+
+    /**
+     * The activity (number of conflicts in which appears) for each positive literal.
+     */
+    std::vector<activity> positiveLiteralActivity;
+
+    /**
+     * The activity (number of conflicts in which appears) for each negative literal.
+     */
+    std::vector<activity> negativeLiteralActivity;
+
+    /**
+     * The total number of conflicts found during the DPLL execution.
+     */
+    uint conflicts;
+
     /**
      * Reads the CNF and initializes
      * any remaining necessary data structures and variables.
      */
     void parseInput();
+    void initClauseAppearances(Atom varcount, uint clausecount);
+    void readClauses(CNFSlice const & src);
+    int currentValueForLiteral(sLiteral literal) const;
+    void setLiteralToTrue(sLiteral literal);
+    void updateActivityForLiteral(sLiteral literal);
+    void updateActivityForConflictingClause(uint clause);
+    bool propagateGivesConflict();
+    void backtrack();
+    sLiteral getNextDecisionLiteral() const;
+
+    /**
+     * Checks for any unit clause and sets the appropriate values in the
+     * model accordingly. If a contradiction is found among these unit clauses,
+     * early failure is triggered.
+     */
+    bool checkUnitClauses();
+
+    /**
+     * Executes the DPLL (Davis�Putnam�Logemann�Loveland) algorithm, performing a full search
+     * for a model (interpretation) which satisfies the formula given as a CNF clause set.
+     */
+    bool DPLL();
 };
 
 #endif // DPLL_H_INCLUDED
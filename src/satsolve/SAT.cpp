@@ -2,19 +2,30 @@
 // typedef SATsolver Solver_used;
 typedef DPLL_solver Solver_used;
 
+// Return true if the clauses of all slices together are satisfiable.
+bool satisfiable(CNFSlices const & slices)
+{
+    bool empty = true;
+    FOR (CNFSlice const & slice, slices)
+    {
+        if (slice.hasemptyclause())
+            return false;
+        empty &= slice.empty();
+    }
+    return empty || Solver_used(slices).sat();
+}
+
 // Return true if the SAT instance and the conclusion are satisfiable.
 bool CNFClauses::sat(CNFClauses const & conclusion) const
 {
-    if (empty() && conclusion.empty())
-        return true;
-    if (hasemptyclause() || conclusion.hasemptyclause())
-        return false;
-    return Solver_used(*this, conclusion).sat();
+    CNFSlices slices(1, slice());
+    slices.push_back(conclusion.slice());
+    return satisfiable(slices);
 }
 
 // Map: free atoms -> truth value.
 // Return the empty vector if unsuccessful.
 Bvector CNFClauses::truthtable(Atom const nfree) const
 {
-    return Solver_used(*this).truthtable(nfree);
+    return Solver_used(CNFSlices(1, slice())).truthtable(nfree);
 }
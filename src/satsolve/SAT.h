@@ -6,39 +6,51 @@
 
 struct SATsolver
 {
-    CNFClauses const & cnf, & cnf2;
-    Atom const cnfatoms, cnf2atoms;
-    SATsolver
-        (CNFClauses const & hyps, CNFClauses const & morehyps = CNFClauses()) :
-        cnf(hyps), cnf2(morehyps),
-        cnfatoms(cnf.natoms()), cnf2atoms(cnf2.natoms()) {}
+    CNFSlices const & slices;
+    Atom const natoms;
+    SATsolver(CNFSlices const & slices) :
+        slices(slices), natoms(countatoms(slices)) {}
     // Map: free atoms -> truth value.
     // Return the empty vector if unsuccessful.
     Bvector truthtable(Atom nfree)
     {
-        static Atom const maxnatoms = std::numeric_limits<Atom>::digits;
+        static Atom const maxnatoms = std::numeric_limits<TTindex>::digits;
         if (nfree > maxnatoms) nfree = maxnatoms;
-        if (nfree > cnfatoms) nfree = cnfatoms;
+        if (nfree > natoms) nfree = natoms;
 
         Bvector tt(static_cast<TTindex>(1) << nfree, false);
-        if (cnf.hasemptyclause()) return tt;
+        FOR (CNFSlice const & slice, slices)
+            if (slice.hasemptyclause()) return tt;
 
-        CNFClauses excnf(cnf);
+        // Slices with unit clauses fixing the free atoms
+        CNFSlices exslices(slices);
+        CNFClauses units;
+        exslices.push_back(units.slice());
         for (TTindex arg = 0; arg < tt.size(); ++arg)
         {
+            units.clear();
             for (Atom i = 0; i < nfree; ++i)
-                excnf.push_back(CNFClause(1, i * 2 + 1 - (arg >> i & 1)));
-            tt[arg] = excnf.sat();
-            excnf.resize(cnf.size());
+                units.closeoff(i, !(arg >> i & 1));
+            exslices.back() = units.slice();
+            tt[arg] = satisfiable(exslices);
         }
         return tt;
     }
+    // Return true if there is no contradiction in the model so far.
+    bool okaysofar(CNFModel const & model) const
+    {
+        FOR (CNFSlice const & slice, slices)
+            for (std::size_t i = 0; i < slice.size(); ++i)
+                if (CNFclausesat(slice[i], model).first == CONTRADICTORY)
+                    return false;
+        return true;
+    }
     // Return true if the SAT instance is satisfiable.
     // Reference backtracking solver
     bool sat()
     {
         // Initial model
-        CNFModel model(std::max(cnfatoms, cnf2atoms));
+        CNFModel model(natoms);
         // Current atom being assigned
         Atom atom = 0;
 
@@ -50,7 +62,7 @@ struct SATsolver
             case UNKNOWN : case FALSE :
                 ++model[atom];
                 // Check if there is a contradiction so far.
-                if (cnf.okaysofar(model) && cnf2.okaysofar(model))
+                if (okaysofar(model))
                 {
                     // No contradiction yet. Move to next atom.
                     if (++atom == model.size())
@@ -74,6 +86,15 @@ struct SATsolver
             }
         }
     }
+private:
+    // Max # atoms of the slices. Return 1 if there is no slice.
+    static Atom countatoms(CNFSlices const & slices)
+    {
+        Atom result = 1;
+        FOR (CNFSlice const & slice, slices)
+            result = std::max(result, slice.natoms());
+        return result;
+    }
 };
 
 #endif // SAT_H_INCLUDED
@@ -1,5 +1,6 @@
 #include <iostream>
 #include "../CNF.h"
+#include "BDD.h"
 #include "../util/arith.h"
 
 static bool checkcnffrom(Bvector const & tt)
@@ -8,7 +9,7 @@ static bool checkcnffrom(Bvector const & tt)
     // Check if cnf built from tt has the same truth table as tt.
     Atom const natoms = util::log2(tt.size());
     CNFClauses cnf(tt);
-    cnf.push_back(CNFClause(1, natoms * 2));
+    cnf.closeoff(natoms);
     if (tt != cnf.truthtable(natoms)) return false;
     // Additional test if tt is constant
     bool const isconst = util::isperiodic(tt.begin(), tt.end(), 1);
@@ -37,7 +38,7 @@ const char * testsat1()
     CNFClauses v;
     if (checksat(v, true))
         return "empty instance";
-    v.resize(1);
+    v.push_back(CNFClause());
     if (checksat(v, false))
         return "empty clause";
     static const Literal a[4][3] = {
@@ -47,14 +48,16 @@ const char * testsat1()
         {1, 4}      // !A, C
     };
     v.clear();
-    v.push_back(CNFClause(a[0], a[0] + 3));
-    v.push_back(CNFClause(a[1], a[1] + 2));
-    v.push_back(CNFClause(a[2], a[2] + 1));
-    v.push_back(CNFClause(a[3], a[3] + 2));
+    v.push_back(a[0], a[0] + 3);
+    v.push_back(a[1], a[1] + 2);
+    v.push_back(a[2], a[2] + 1);
+    CNFClauses w(v);
+    v.push_back(a[3], a[3] + 2);
     if (checksat(v, true))
         return "satisfiable instance";
-    v[3][1] = 5;    // !A, !C
-    if (checksat(v, false))
+    static const Literal b[] = {1, 5}; // !A, !C
+    w.push_back(b, b + 2);
+    if (checksat(w, false))
         return "satisfiable instance";
 
     return "OKay";
@@ -71,20 +74,72 @@ unsigned testsat2(unsigned n)
     for (unsigned i = 1u; i <= n; ++i)
     {
         // Create a CNF with all possible 2^i clauses.
-        CNFClauses cnf(static_cast<CNFClauses::size_type>(1) << i);
-        for (CNFClauses::size_type j = 0; j < cnf.size(); ++j)
+        CNFClauses cnf;
+        CNFClause clause(i);
+        CNFClauses::size_type const n
+            = static_cast<CNFClauses::size_type>(1) << i;
+        for (CNFClauses::size_type j = 0; j < n; ++j)
         {
-            cnf[j].resize(i);
             for (CNFClause::size_type k = 0; k < i; ++k)
-                cnf[j][k] = (j >> k) & 1;
+                clause[k] = (j >> k) & 1;
+            cnf.push_back(clause);
         }
         // This CNF should be UNSATISFIABLE.
         if (cnf.sat()) return i;
-        // Remove the last clause.
-        cnf.pop_back();
-        // This CNF should be SATISFIABLE.
-        if (!cnf.sat()) return i;
+        // Without the last clause, it should be SATISFIABLE.
+        if (!satisfiable(CNFSlices(1, cnf.slice(0, n - 1)))) return i;
     }
 
     return 0;
 }
+
+// Test BDDs of all connectives with n arguments against their truth tables.
+// Return true if okay.
+bool testbdd(unsigned n)
+{
+    TTindex const nrows = static_cast<TTindex>(1) << n;
+    std::size_t const nfuns = static_cast<std::size_t>(1) << nrows;
+    BDDs bdds;
+    BDDs::Refs args(n);
+    for (Atom i = 0; i < n; ++i)
+        args[i] = bdds.var(i);
+    // BDDs of all functions
+    std::vector<Bvector> tts(nfuns, Bvector(nrows));
+    BDDs::Refs funs(nfuns);
+    for (std::size_t i = 0; i < nfuns; ++i)
+    {
+        for (TTindex row = 0; row < nrows; ++row)
+            tts[i][row] = i >> row & 1;
+        funs[i] = bdds.apply(tts[i], args.data(), n);
+    }
+    // Check canonicity and implications.
+    for (std::size_t i = 0; i < nfuns; ++i)
+        for (std::size_t j = 0; j < nfuns; ++j)
+        {
+            if ((funs[i] == funs[j]) != (i == j))
+                return false;
+            Tribool const implied = (i & ~j) == 0 ? TRUE : FALSE;
+            if (bdds.implies(funs[i], funs[j]) != implied)
+                return false;
+        }
+    // Check connectives applied to functions.
+    static const bool andtt[] = {0, 0, 0, 1};
+    Bvector const conj(andtt, andtt + 4);
+    for (std::size_t i = 0; i < nfuns; ++i)
+        for (std::size_t j = 0; j < nfuns; ++j)
+        {
+            BDDs::Ref const fg[] = {funs[i], funs[j]};
+            if (bdds.apply(conj, fg, 2) != funs[i & j] ||
+                bdds.conj(funs[i], funs[j]) != funs[i & j])
+                return false;
+        }
+    if (n < 2)
+        return true;
+    // Check failure at the node limit, with room for the variables only.
+    BDDs small(n + 1);
+    for (Atom i = 0; i < n; ++i)
+        args[i] = small.var(i);
+    return small.conj(args[0], args[1]) == BDDs::none() &&
+            small.implies(args[0], args[1]) == UNKNOWN &&
+            small.conj(args[0], args[0]) == args[0];
+}
@@ -38,13 +38,14 @@ bool Problem::ranksimplerthanProb(Game const & game) const
 {
     return game.env().rankssimplerthanProb &&
         database.syntaxDAG().simplerthan
-        (database.syntaxDAG().RPNranks(game.goal().rpn), maxranks);
+        (game.goal().ranks(database.syntaxDAG()), maxranks);
 }
 
 // Evaluate the leaf. Return {value, sure?}.
 // p should != nullptr.
 Eval Problem::evalleaf(pNode p) const
 {
+    setchanged(p);
     Game const & game = p->game();
     if (game.attempt.type == Move::THM)
     {
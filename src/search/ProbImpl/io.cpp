@@ -235,7 +235,8 @@ void Problem::printenvs() const
         SyntaxDAG::Ranks const & envranks = env.second->maxranks;
         char const c = " *"[env.second->rankssimplerthanProb];
         std::cout << c << env.second->label << '\t';
-        FOR (std::string const & rank, env.second->maxranks)
+        FOR (std::string const & rank,
+             database.syntaxDAG().ranknames(envranks))
             std::cout << rank << ' ';
         std::cout << std::endl;
     }
@@ -245,7 +246,7 @@ void Problem::printenvs() const
 void Problem::printranksinfo() const
 {
     std::cout << maxranknumber << " < " << numberlimit << '\t';
-    FOR (std::string const & rank, maxranks)
+    FOR (std::string const & rank, database.syntaxDAG().ranknames(maxranks))
         std::cout << rank << ' ';
     std::cout << std::endl;
     printenvs();
@@ -419,7 +420,7 @@ void Problem::printabs() const
 std::string Problem::proofstr(pNode p) const
 {
     Game const & game = p->game();
-    RPN const & rpn = game.proof();
+    RPN const & rpn = flatten(game.proof());
     Printer printer(&database.typecodes());
     Expression const & conclusion(verify(rpn, printer));
     Expression const & expression(game.goal().expression());
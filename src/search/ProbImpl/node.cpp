@@ -6,7 +6,7 @@ void Problem::closenodesexcept(pNodes const & pnodes, pNode p)
     FOR (pNode other, pnodes)
         if (other != p && !other->won())
         {
-            setwin(other);
+            setwin(other), setchanged(other);
             pNode parent = other.parent();
             if (parent && !parent->won())
                 backprop(parent);
@@ -34,7 +34,7 @@ void Problem::copyproof(Game const & game)
                 break;  // end reached
             if (*supiter != &otherEnv)
                 continue;
-            // Super-context found. Copy proof.
+            // Super-context found. Share proof.
             goaldata.second.proofdst() = game.proof();
             goaldata.second.settrue();
             closenodesexcept(goaldata.second.pnodes());
@@ -51,6 +51,7 @@ void Problem::closenodes(pNode p)
 
 void Problem::backpropcallback(pNode p)
 {
+    setchanged(p);
     if (p->game().proven())
         setwin(p); // Fix seteval in backprop.
     else if (p->won() && p->game().writeproof())
@@ -8,38 +8,80 @@ void Problem::reval()
         return;
     // printranksinfo();
     numberlimit = maxranknumber;
-    maxranks.clear();
     prune(root());
-    updateimps();
+    SyntaxDAG::Ranks const oldranks(maxranks);
+    maxranks = leafmaxranks();
+    // Contexts added since the last reval were compared with maxranks
+    // by initEnv, so the others need updating only if maxranks changed.
+    if (maxranks != oldranks)
+        updateimps();
     focus(root());
     maxranknumber = database.syntaxDAG().maxranknumber(maxranks);
     // printranksinfo();
 }
 
-// Add the ranks of a node to maxranks, if almost won.
-void Problem::addranks(pNode p)
+// Count or uncount the ranks of a node in rankcounts.
+void Problem::countranks(pNode p, bool counted)
 {
-    if (value(p) < ALMOSTWIN)
+    Game const & game = p->game();
+    if (game.counted == counted)
         return;
-    database.syntaxDAG().addranks(maxranks, p->game().env().maxranks);
-    database.syntaxDAG().addexp(maxranks, p->game().goal().rpn);
+    game.counted = counted;
+
+    SyntaxDAG const & syntaxDAG = database.syntaxDAG();
+    SyntaxDAG::Ranks const & envranks = game.env().maxranks;
+    SyntaxDAG::Ranks const & goalranks = game.goal().ranks(syntaxDAG);
+    rankcounts.resize(syntaxDAG.nranks());
+    for (SyntaxDAG::Rank rank = 0; rank < syntaxDAG.nranks(); ++rank)
+    {
+        std::size_t const n = SyntaxDAG::has(envranks, rank)
+                            + SyntaxDAG::has(goalranks, rank);
+        if (counted)
+            rankcounts[rank] += n;
+        else
+            rankcounts[rank] -= n;
+    }
 }
 
-// Prune the sub-tree at p and update maxranks, if almost won.
+// Max ranks of almost-won leaves
+SyntaxDAG::Ranks Problem::leafmaxranks() const
+{
+    SyntaxDAG const & syntaxDAG = database.syntaxDAG();
+    SyntaxDAG::Ranks ranks(util::nwords<std::size_t>(syntaxDAG.nranks()));
+    for (SyntaxDAG::Rank rank = 0; rank < rankcounts.size(); ++rank)
+        if (rankcounts[rank])
+            util::setbit(ranks, rank);
+    SyntaxDAG::Ranks result;
+    syntaxDAG.addranks(result, ranks);
+    return result;
+}
+
+// Prune the changed part of the sub-tree at p
+// and count the ranks of almost-won leaves.
+// Unchanged sub-trees have been pruned in the last reval.
+// Leaves are always pruned, as new ones may not be evaluated.
 void Problem::prune(pNode p)
 {
     if (p.haschild())
     {
+        if (!p->game().changed)
+            return;
+        p->game().changed = false;
+        countranks(p, false);
         FOR (pNode child, *p.children())
             prune(child);
         seteval(p, minimax(p));
         if (p->won() && !p->game().proven())
             std::cout << "prune" << std::endl, navigate(p);
     }
-    else if (value(p) < ALMOSTWIN)
-        setalmostloss(p);
     else
-        addranks(p);
+    {
+        p->game().changed = false;
+        if (value(p) < ALMOSTWIN)
+            setalmostloss(p), countranks(p, false);
+        else
+            countranks(p, true);
+    }
 }
 
 // Update implications after problem context is simplified.
@@ -56,11 +98,21 @@ void Problem::updateimps()
 }
 
 // Focus the sub-tree at p, with updated maxranks, if almost won.
+// Every almost-won leaf is re-evaluated, not only those whose ranks
+// changed, since evalleaf may expand the leaf and must run as before.
+// evalleaf marks the leaf changed. Prune has unmarked the whole tree,
+// so a node stays marked only if it was marked before focus reached it,
+// or its evaluation or a child changed.
+// Otherwise the next prune would revisit the whole almost-won frontier.
 void Problem::focus(pNode p)
 {
     if (value(p) < ALMOSTWIN)
         return;
-    if (p.haschild())
+    // Marked by nodes closed while focusing other sub-trees?
+    bool const marked = p->game().changed;
+    Eval const oldeval = p->eval();
+    bool const wasleaf = !p.haschild();
+    if (!wasleaf)
     {
         FOR (pNode child, *p.children())
             focus(child);
@@ -69,4 +121,14 @@ void Problem::focus(pNode p)
         //     std::cout << "prune" << std::endl, navigate(p);
     }
     else seteval(p, evalleaf(p));
+    // Changed if expanded by evalleaf or evaluated differently
+    bool changed = marked || (wasleaf && p.haschild()) ||
+                    p->eval() != oldeval;
+    // Nodes closed by evalleaf elsewhere are marked with their ancestors,
+    // so read the marks of the children after all of them are focused.
+    if (!changed && p.haschild())
+        FOR (pNode child, *p.children())
+            if ((changed = child->game().changed))
+                break;
+    p->game().changed = changed;
 }
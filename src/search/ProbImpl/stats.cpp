@@ -3,10 +3,8 @@
 // Return true if proof() solves the problem *iter.
 bool Problem::checkproof(Assiter iter) const
 {
-    return probEnv().legal(proof()) &&
-        checkconclusion(iter->first,
-                        verify(proof(), &*iter),
-                        iter->second.expression);
+    RPN const & rpn = proof();
+    return probEnv().legal(rpn) && checkconclusion(rpn, &*iter);
 }
 
 // # goals of a given status
@@ -28,7 +28,7 @@ Environ::MoveValidity Environ::validthmmove(Move const & move) const
         return MoveINVALID;
     if (prob().database.typecodes().isprimitive(move.goaltypecode()) != FALSE)
         return MoveINVALID;
-    if (!move.checkDV(assertion))
+    if (!move.checkDV(assertion, DV))
         return MoveINVALID;
     // True if all goals of the move are proven
     bool allproven = true;
@@ -117,29 +117,42 @@ Environ::MoveValidity Environ::validconjmove(Move const & move) const
     return MoveVALID;
 }
 
+// Return true if an essential hypothesis can be used in a proof.
+bool Environ::legal(pHyp phyp) const
+{
+    Bank const & bank = prob().bank;
+    Hypiter const iter = bank.findhyp(phyp->first);
+    if (iter == bank.hypotheses().end())
+        return true; // Problem hypothesis
+    if (subsumedbyProb())
+        return false; // Non-problem hypothesis in sub-context
+    return util::filter(assertion.hypiters)(iter);
+}
+
 // Return true if a proof is legal.
 bool Environ::legal(RPN const & proof) const
 {
     if (!pProb)
         return false;
 
-    Bank const & bank = prob().bank;
-    Hypiter const end = bank.hypotheses().end();
-
     FOR (RPNstep const step, proof)
         if (step.isthm() && step.pass->second.number >= assnum())
             return false; // Theorem # too large
         else
-        if (step.ishyp() && !step.phyp->second.floats)
-        {
-            Hypiter const iter = bank.findhyp(step.phyp->first);
-            if (iter == end)
-                continue; // Problem hypothesis
-            if (subsumedbyProb())
-                return false; // Non-problem hypothesis in sub-context
-            if (!util::filter(assertion.hypiters)(iter))
-                return false; // Not hypothesis in this context
-        }
+        if (step.ishyp() && !step.phyp->second.floats && !legal(step.phyp))
+            return false; // Not hypothesis in this context
+    return true;
+}
+
+// Return true if a proof is legal, by the theorems and hypotheses it uses.
+bool Environ::legal(Proofnode const & proof) const
+{
+    if (!pProb || proof.nthm > assnum())
+        return false; // Theorem # too large
+
+    FOR (pHyp const phyp, proof.hyps)
+        if (!legal(phyp))
+            return false; // Not hypothesis in this context
     return true;
 }
 
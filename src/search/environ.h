@@ -27,6 +27,8 @@ struct Environ : protected Gen
         label(ass.hypslabel()),
         hypsweight(ass.hypslen()),
         hasnewvarinexp(ass.hasnewvarinexp()),
+        DV(ass.disjvars, ass.varusage),
+        id(newid()),
         pProb(),
         sortedhyps(ass.hypiters),
         m_subsumedbyProb(false),
@@ -71,9 +73,20 @@ struct Environ : protected Gen
     virtual Moves ourmoves(Game const & game, stage_t stage) const;
     // Weight of the goal
     virtual Weight weight(RPN const & goal) const { return goal.size(); }
+    // Contexts with the same weight key weigh goals the same.
+    virtual std::size_t weightkey() const { return 0; }
     // Weight of the game
     Weight weight(Game const & game) const
-    { return hypsweight + weight(game.goal().rpn); }
+    {
+        Goalcache & cache = game.goal().cache;
+        if (!cache.hasweight || cache.weightkey != weightkey())
+        {
+            cache.weight = weight(game.goal().rpn);
+            cache.weightkey = weightkey();
+            cache.hasweight = true;
+        }
+        return hypsweight + cache.weight;
+    }
     // Evaluate leaf games, and record the proof if proven.
     virtual Eval evalourleaf(Game const & game) const
     { return score(weight(game) + game.wDefer()); }
@@ -82,6 +95,8 @@ struct Environ : protected Gen
     virtual Environ * makeEnv(Assertion const &) const { return NULL; };
     // Return true if a proof is legal.
     bool legal(RPN const & proof) const;
+    // Return true if a proof is legal, by the theorems and hypotheses it uses.
+    bool legal(Proofnode const & proof) const;
 // Data members
     // The assertion to be proved
     Assertion const & assertion;
@@ -93,7 +108,13 @@ struct Environ : protected Gen
     Weight hypsweight;
     // True if there is a var only used in exp.
     bool const hasnewvarinexp;
+    // Disjoint variable hypotheses as a bit-matrix
+    DVmatrix const DV;
+    // Id of the context, unique in the run, to key per-context caches
+    std::size_t const id;
 protected:
+    // Return a new context id, never reused.
+    static std::size_t newid() { static std::size_t n = 0; return n++; }
     // Pointer to the problem
     Problem * pProb;
     friend Problem;
@@ -144,6 +165,8 @@ private:
     mutable bool rankssimplerthanProb;
     // Return true if hypotheses of *this contains those of env.
     bool implies(Environ const & env) const;
+    // Return true if an essential hypothesis can be used in a proof.
+    bool legal(pHyp phyp) const;
     // Update context implication relations.
     void addsubEnv(Environ const & env) const
     { util::addordered(m_psubEnvs, &env); }
@@ -7,14 +7,14 @@
 Goaldata & Game::goaldata() const { return pgoal->second; }
 Goaldatas & Game::goaldatas() const { return goaldata().goaldatas(); }
 Goal const & Game::goal() const { return goaldata().goal(); }
-RPN const & Game::proof() const { return goaldata().proofsrc(); }
+pProofnode const & Game::proof() const { return goaldata().proofsrc(); }
 Environ const & Game::env() const { return *pgoal->first; }
 
 std::ostream & operator<<(std::ostream & out, Game const & game)
 {
     out << game.goal().expression();
     if (game.proven())
-        out << "Proof: " << game.proof();
+        out << "Proof: " << flatten(game.proof());
     if (game.attempt.type != Move::NONE)
         out << "Proof attempt (" << game.nDefer << ") "
             << game.attempt.label() << std::endl;
@@ -77,15 +77,17 @@ Moves Game::ourmoves(stage_t stage) const
     return moves;
 }
 
-static void printthmhypproofs(Move const & move, pProofs const & phyps)
+static void printthmhypproofs(Move const & move)
 {
     std::cerr << "Proofs of hypotheses are" << std::endl;
     for (Hypsize i = 0; i < move.nsubgoals(); ++i)
-        std::cerr << move.subgoallabel(i) << '\t' << *phyps[i];
+        std::cerr << move.subgoallabel(i) << '\t' <<
+        (move.subgoalfloats(i) ? move.substitutions[move.hypvar(i).id] :
+         flatten(move.subgoalproof(i)));
 }
 
 // Move the proof from scr to dst, and redirect the pointer.
-static void moveproof(RPN * & src, RPN & dst)
+static void moveproof(pProofnode * & src, pProofnode & dst)
 {
     dst.swap(*src);
     src = &dst;
@@ -97,18 +99,17 @@ bool Game::writeproof() const
 {
     if (attempt.type == Move::NONE || proven())
         return false;
-    if (!attempt.checkDV(env().assertion, true))
+    if (!attempt.checkDV(env().assertion, env().DV, true))
         return false;
 // std::cout << "Writing proof: " << goal().expression();
     // attempt.type == Move::THM || Move::CONJ, goal not proven
-    RPN * pproof = &goaldata().proofdst();
-    // Pointers to proofs of sub-goals
-    pProofs const phyps(attempt.phyps());
-    // Write proof.
-    if (!attempt.writeproof(*pproof, phyps))
+    pProofnode * pproof = &goaldata().proofdst();
+    // Write proof, sharing the proofs of sub-goals, and verify the new step.
+    if (!(*pproof = attempt.writeproof()))
         return false;
+    Proofnode const & node = **pproof;
     if (pproof != &goaldatas().proof)
-        if (env().prob().probEnv().legal(*pproof))
+        if (env().prob().probEnv().legal(node))
             // Proof works in problem context. Move it there.
             moveproof(pproof, goaldatas().proof);
         else
@@ -134,7 +135,7 @@ bool Game::writeproof() const
                         if (subiter == subend)
                             break;  // end reached
                         if (*subiter == &subEnv &&
-                            subEnv.legal(*pproof))
+                            subEnv.legal(node))
                         {
                             // Proof holds in sub-context.
                             pcurgoal = &goaldata;
@@ -148,10 +149,17 @@ bool Game::writeproof() const
                 moveproof(pproof, pcurgoal->second.proofdst());
         }
     // Verification
-    const Expression & exp(verify(*pproof));
+#ifdef SEARCH_FULLVERIFY
+    // Debug: re-verify the whole proof against the cached conclusion.
+    const Expression & exp(verify(flatten(*pproof)));
+    if (exp != node.conclusion)
+        std::cerr << "Cached conclusion\n" << node.conclusion;
+#else
+    const Expression & exp(node.conclusion);
+#endif // SEARCH_FULLVERIFY
     const bool okay = (exp == goal().expression());
     if (!okay)
-        printthmhypproofs(attempt, phyps);
+        printthmhypproofs(attempt);
     if (okay)
     {
 // std::cout << "Built proof for " << goal().expression();
@@ -160,7 +168,7 @@ bool Game::writeproof() const
     else
     {
         writeprooferr(exp);
-        pproof->clear();
+        pproof->reset();
     }
     return okay;
 }
@@ -168,6 +176,6 @@ bool Game::writeproof() const
 void Game::writeprooferr(Expression const & exp) const
 {
     std::cerr << "When using " << attempt.label() << ", the proof\n";
-    std::cerr << proof() << "proves\n" << exp;
+    std::cerr << flatten(proof()) << "proves\n" << exp;
     std::cerr << "instead of\n" << goal().expression();
 }
@@ -22,12 +22,18 @@ struct Game
     stage_t nDefer;
     // Proof attempt made, on their turn
     Move attempt;
-    Game(pGoal p = pGoal(), stage_t n = 0) : pgoal(p), nDefer(n) {}
+    // Evaluation changed since the last reval?
+    // Ancestors of a changed node are also changed.
+    mutable bool changed;
+    // Ranks counted among those of almost-won leaves?
+    mutable bool counted;
+    Game(pGoal p = pGoal(), stage_t n = 0) :
+        pgoal(p), nDefer(n), changed(false), counted(false) {}
     Goaldata & goaldata() const;
     Goaldatas & goaldatas() const;
     Goal const & goal() const;
-    RPN const & proof() const;
-    bool proven() const { return !proof().empty(); }
+    pProofnode const & proof() const;
+    bool proven() const { return static_cast<bool>(proof()); }
     Environ const & env() const;
     Weight wDefer() const { return static_cast<Weight>(nDefer); }
     friend std::ostream & operator<<(std::ostream & out, Game const & game);
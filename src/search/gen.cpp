@@ -4,8 +4,22 @@
 #include "../util/FMA.h"
 #include "../util/for.h"
 
-// Return the typecodes of the arguments of a syntax axiom.
-static Argtypes argtypes(RPN const & syntaxiom)
+// Return the index of a type code, adding it if new.
+Typenum Gen::typenum(strview type) const
+{
+    std::pair<std::map<strview, Typenum>::iterator, bool> const result
+        (m_typenums.insert(std::make_pair(type, m_typecodes.size())));
+    if (result.second)
+    {
+        m_typecodes.push_back(type);
+        genresult.resize(m_typecodes.size());
+        termcounts.resize(m_typecodes.size());
+    }
+    return result.first->second;
+}
+
+// Return the types of the arguments of a syntax axiom.
+Argtypes Gen::argtypes(RPN const & syntaxiom) const
 {
     if (syntaxiom.empty())
         return Argtypes();
@@ -16,23 +30,12 @@ static Argtypes argtypes(RPN const & syntaxiom)
         RPNstep const step = syntaxiom[i];
         if (!step.id())
             return Argtypes();
-        result[i] = step.phyp->second.expression[0];
+        result[i] = typenum(step.phyp->second.expression[0]);
     }
 
     return result;
 }
 
-// Return the sum of the sizes of substituted arguments.
-static RPNsize argssize
-    (Argtypes const & argtypes, Genresult const & result,
-     Genstack const & stack)
-{
-    RPNsize size = 0;
-    for (Genstack::size_type i = 0; i < stack.size(); ++i)
-        size += result.at(argtypes[i])[stack[i]].size();
-    return size;
-}
-
 // Return a lower bound of the number of potential substitutions.
 RPNsize Gen::substcount(Argtypes const & argtypes, Genstack const & stack) const
 {
@@ -40,9 +43,9 @@ RPNsize Gen::substcount(Argtypes const & argtypes, Genstack const & stack) const
     for (Genstack::size_type i = 0; i < stack.size(); ++i)
     {
         // Type of the substitution
-        strview type = argtypes[i];
+        Typenum type = argtypes[i];
         // Multiplier
-        RPNsize mul = termcounts[type][genresult[type][stack[i]].size()];
+        RPNsize mul = termcounts[type][genresult[type].termsize(stack[i])];
         if (!util::FMA(count, mul, 0))
             return static_cast<RPNsize>(-1);
     }
@@ -56,91 +59,90 @@ bool Gen::next(Argtypes const & argtypes, RPNsize size, Genstack & stack) const
     while (!stack.empty())
     {
         // Check if size of the last substitution is maximal.
-        if (argssize(argtypes, genresult, stack)
-            < size - 1 - argtypes.size() + stack.size())
+        if (stack.argssize < size - 1 - argtypes.size() + stack.size())
             break;
-        // Type of the last substitution
-        strview type = argtypes[stack.size() - 1];
+        // Terms of the type of the last substitution
+        Typenum type = argtypes[stack.size() - 1];
         // Index of the last substitution
         Terms::size_type index = stack.back();
         // Check if indexe of the last substitution is maximal.
-        if (index < termcounts[type][genresult[type][index].size()] - 1)
+        if (index < termcounts[type][genresult[type].termsize(index)] - 1)
             break;
         // It is maximal. Backtrack to the previous substitution.
-        stack.pop_back();
+        pop(argtypes, stack);
     }
-    return !stack.empty() && ++stack.back();
-}
-
-static RPN writeRPN
-    (Argtypes const & argtypes, Genresult const & result,
-     Genstack const & stack, RPNstep const root)
-{
-    RPN term;
-    // Preallocate for efficiency.
-    term.reserve(argssize(argtypes, result, stack));
-
-    for (Genstack::size_type i = 0; i < stack.size(); ++i)
-        term += result.at(argtypes[i])[stack[i]];
-    term.push_back(root);
-
-    return term;
+    if (stack.empty())
+        return false;
+    // Replace the last substitution by the next term.
+    Terms::size_type const index = stack.back();
+    pop(argtypes, stack);
+    push(argtypes, index + 1, stack);
+    return true;
 }
 
 // Adds a generated term.
 struct Termadder : Adder
 {
-    Terms & terms;
+    Genresult & result;
+    Typenum const type;
     RPNstep const root;
-    Termadder(Terms & terms, RPNstep const root) :
-        terms(terms), root(root) {}
+    Termadder(Genresult & result, Typenum type, RPNstep const root) :
+        result(result), type(type), root(root) {}
     // Add a move. Return true if the move closed the goal.
-    virtual bool operator()(Argtypes const & types, Genresult const & result,
+    virtual bool operator()(Argtypes const & types, Genresult const &,
                             Genstack const & stack)
     {
-        terms.push_back(writeRPN(types, result, stack, root));
+        Terms & terms = result[type];
+        // Preallocate so that the arguments stay put while being copied.
+        terms.reserve(stack.argssize + 1);
+
+        for (Genstack::size_type i = 0; i < stack.size(); ++i)
+        {
+            RPNspan const arg = result[types[i]][stack[i]];
+            for (RPNiter iter = arg.first; iter != arg.second; ++iter)
+                terms.steps.push_back(*iter);
+        }
+        terms.steps.push_back(root);
+        terms.closeterm();
+
         return false;
     }
 };
 
 // Generate all terms of size 1.
-Terms Gen::generateupto1(strview type) const
+void Gen::generateupto1(Typenum type) const
 {
-    Terms terms;
-    // Preallocate for efficiency.
-    terms.reserve(m_varusage.size());
+    Terms & terms = genresult[type];
+    strview const typecode = m_typecodes[type];
 
     // Generate all variables of the type.
     FOR (Varusage::const_reference var, m_varusage)
-        if (var.first.typecode() == type)
-            terms.push_back(RPN(1, var.first.iter));
+        if (var.first.typecode() == typecode)
+            terms.steps.push_back(var.first.iter), terms.closeterm();
 
     // Generate all 1-step syntax axioms.
     FOR (Syntaxioms::const_reference syntaxiom, syntaxioms)
     {
         Assertion const & ass(syntaxiom.second.pass->second);
-        if (ass.expRPN.size() == 1 && ass.exptypecode() == type)
+        if (ass.expRPN.size() == 1 && ass.exptypecode() == typecode)
             terms.push_back(ass.expRPN);
     }
-
-    return terms;
 }
 
 // Generate all terms with RPN up to a given size.
 // Stop and return false when max count is exceeded.
-void Gen::generateupto(strview type, RPNsize size) const
+void Gen::generateupto(Typenum type, RPNsize size) const
 {
-    Terms & terms = genresult[type];
-    Termcounts::mapped_type & countbysize = termcounts[type];
+    std::vector<Terms::size_type> & countbysize = termcounts[type];
     // Preallocate for efficiency.
     countbysize.reserve(size + 1);
 
     if (countbysize.empty())
     {
-        terms = generateupto1(type);
+        generateupto1(type);
         // Record # of size 1 terms.
         countbysize.resize(2);
-        countbysize[1] = terms.size();
+        countbysize[1] = genresult[type].size();
     }
 
     if (countbysize.size() >= size + 1)
@@ -152,7 +154,7 @@ void Gen::generateupto(strview type, RPNsize size) const
     {
         Assertion const & ass = syntaxiom.second.pass->second;
         if (ass.expRPN.size() <= 1 || ass.expRPN.size() > size ||
-            ass.exptypecode() != type)
+            ass.exptypecode() != m_typecodes[type])
             continue; // Syntax axiom mismatch
 
         Argtypes const & types = argtypes(ass.expRPN);
@@ -160,13 +162,14 @@ void Gen::generateupto(strview type, RPNsize size) const
             continue; // Bad syntax axiom
 
         // Callback functor to add terms
-        Termadder adder(terms, ass.expRPN.back());
+        Termadder adder(genresult, type, ass.expRPN.back());
         // Main loop of term generation
         dogenerate(types, size, adder);
     }
-    // Record the # of terms.
-    countbysize.insert(countbysize.end(),
-                       size + 1 - countbysize.size(), terms.size());
+    // Record the # of terms. New types may have been added.
+    std::vector<Terms::size_type> & counts = termcounts[type];
+    counts.insert(counts.end(),
+                  size + 1 - counts.size(), genresult[type].size());
 }
 
 // Generate all terms for all arguments with RPN up to a given size.
@@ -183,21 +186,21 @@ bool Gen::dogenerate(Argtypes const & argtypes, RPNsize size, Adder & adder) con
     {
         if (stack.size() < nargs) // Not all args seen
         {
-            strview type = argtypes[stack.size()];
+            Typenum type = argtypes[stack.size()];
             RPNsize argsize = size - nargs + stack.size();
-            argsize -= argssize(argtypes, genresult, stack);
+            argsize -= stack.argssize;
             generateupto(type, argsize);
             if (genresult[type].empty())
                 return false; // Argument generation failed
 
             if (stack.size() < nargs - 1) // At least 2 args unseen
-                stack.push_back(0);
+                push(argtypes, 0, stack);
             else
             {
                 // Size of the only unseen arg
-                RPNsize lastsize = size - 1 - argssize(argtypes, genresult, stack);
+                RPNsize lastsize = size - 1 - stack.argssize;
                 // 1st substitution with that size
-                stack.push_back(termcounts[type][lastsize - 1]);
+                push(argtypes, termcounts[type][lastsize - 1], stack);
             }
         }
         else
@@ -210,34 +213,6 @@ bool Gen::dogenerate(Argtypes const & argtypes, RPNsize size, Adder & adder) con
             next(argtypes, size, stack);
         }
     } while (!stack.empty());
-    
+
     return true;
 }
-
-// Generate all terms whose RPN is of a given size.
-// Terms generate
-//     (Varusage const & varusage, Syntaxioms const & syntaxioms,
-//      strview type, RPNsize size)
-// {
-//     if (size == 0)
-//         return Terms();
-
-//     Genresult result;
-//     Termcounts counts;
-//     generateupto(varusage, syntaxioms, type, size, result, counts);
-
-//     return Terms(result[type].begin() + counts[type][size - 1],
-//                  result[type].end());
-// }
-
-// Terms generate(struct Assertion const & assertion,
-//                Syntaxioms const & syntaxioms,
-//                strview type, RPNsize size)
-// {
-//     Syntaxioms filtered;
-//     FOR (Syntaxioms::const_reference syntaxiom, syntaxioms)
-//         if (syntaxiom.second.assiter->second.number <= assnum())
-//             filtered.insert(syntaxiom);
-
-//     return generate(assertion.varusage, filtered, type, size);
-// };
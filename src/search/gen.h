@@ -1,18 +1,56 @@
 #ifndef GEN_H_INCLUDED
 #define GEN_H_INCLUDED
 
+#include <algorithm>  // for std::max
 #include "../syntaxiom.h"
 
-// vector of generated terms
-typedef std::vector<RPN> Terms;
-// map: type -> terms
-typedef std::map<strview, Terms> Genresult;
+// Flat arena of generated terms, all RPN steps in one contiguous buffer
+struct Terms
+{
+    typedef std::vector<RPNsize>::size_type size_type;
+    // RPN steps of all the terms, back to back
+    RPN steps;
+    // offsets[i] = start of term i in steps. offsets.back() = steps.size().
+    std::vector<RPNsize> offsets;
+    Terms() : offsets(1, 0) {}
+    // # terms
+    size_type size() const { return offsets.size() - 1; }
+    bool empty() const { return size() == 0; }
+    // Size of term i
+    RPNsize termsize(size_type i) const { return offsets[i + 1] - offsets[i]; }
+    // Term i. Invalidated when the arena grows.
+    RPNspan operator[](size_type i) const
+    { return RPNspan(steps.begin() + offsets[i], steps.begin() + offsets[i+1]); }
+    // Make room for n more steps, growing geometrically.
+    void reserve(RPNsize n)
+    {
+        if (steps.capacity() - steps.size() < n)
+            steps.reserve(std::max(steps.size() + n, 2 * steps.capacity()));
+    }
+    // Close the term being written.
+    void closeterm() { offsets.push_back(steps.size()); }
+    // Add a term.
+    void push_back(RPN const & term)
+    {
+        steps.insert(steps.end(), term.begin(), term.end());
+        closeterm();
+    }
+};
+// Index of a type code in the generator
+typedef std::vector<Terms>::size_type Typenum;
+// Genresult[type] = terms of type
+typedef std::vector<Terms> Genresult;
 // Counts[type][i] = # of terms up to size i
-typedef std::map<strview, std::vector<Terms::size_type> > Termcounts;
-// Argtypes[i] = typecode of argument i
-typedef std::vector<strview> Argtypes;
+typedef std::vector<std::vector<Terms::size_type> > Termcounts;
+// Argtypes[i] = type of argument i
+typedef std::vector<Typenum> Argtypes;
 // Genstack[i] = # of terms substituted for argument i
-typedef std::vector<Terms::size_type> Genstack;
+struct Genstack : std::vector<Terms::size_type>
+{
+    // Sum of the sizes of substituted arguments
+    RPNsize argssize;
+    Genstack() : argssize(0) {}
+};
 
 // Virtual base class for adder
 struct Adder
@@ -32,20 +70,43 @@ struct Gen
     Syntaxioms  mutable syntaxioms;
     Genresult   mutable genresult;
     Termcounts  mutable termcounts;
+// Return the index of a type code, adding it if new.
+    Typenum typenum(strview type) const;
+// Return the types of the arguments of a syntax axiom.
+    Argtypes argtypes(RPN const & syntaxiom) const;
 // Return a lower bound of the number of potential substitutions.
     RPNsize substcount(Argtypes const & argtypes, Genstack const & stack) const;
+// Push a substitution onto the stack.
+    void push(Argtypes const & argtypes, Terms::size_type index,
+              Genstack & stack) const
+    {
+        stack.push_back(index);
+        stack.argssize += genresult[argtypes[stack.size() - 1]].termsize(index);
+    }
+// Pop the last substitution off the stack.
+    void pop(Argtypes const & argtypes, Genstack & stack) const
+    {
+        stack.argssize -=
+        genresult[argtypes[stack.size() - 1]].termsize(stack.back());
+        stack.pop_back();
+    }
 // Advance the stack and return true if it can be advanced.
 // Clear the stack and return false if it cannot be advanced.
     bool  next(Argtypes const & argtypes, RPNsize size, Genstack & stack) const;
 // Generate all terms of size 1.
-    Terms generateupto1(strview type) const;
+    void generateupto1(Typenum type) const;
 // Generate all terms with RPN up to a given size.
 // Skip when max count is exceeded.
-    void generateupto(strview type, RPNsize size) const;
+    void generateupto(Typenum type, RPNsize size) const;
 // Generate all terms for all arguments with RPN up to a given size.
 // Skip when max count is exceeded.
 // Return true if a move closed the goal.
     bool dogenerate(Argtypes const & argtypes, RPNsize size, Adder & adder) const;
+private:
+    // Map: type code -> its index
+    std::map<strview, Typenum> mutable m_typenums;
+    // m_typecodes[i] = type code with index i
+    std::vector<strview> mutable m_typecodes;
 };
 
 #endif // GEN_H_INCLUDED
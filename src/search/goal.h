@@ -1,23 +1,88 @@
 #ifndef GOAL_H_INCLUDED
 #define GOAL_H_INCLUDED
 
+#include "../CNF.h"
+#include "../fingerprint.h"
+#include "../satsolve/BDD.h"
+#include "../syntaxDAG.h"
 #include "../util/algo.h"   // for util::compare
 #include "../proof/analyze.h"
 #include "../proof/verify.h"
 
+// Data derived from a goal, computed lazily and only once.
+// Spans in it point into the goal, so copies start empty.
+struct Goalcache
+{
+    // AST of the goal
+    AST ast;
+    // Maximal abstractions of the goal
+    GovernedRPNspansbystep maxabs;
+    bool hasmaxabs;
+    // Syntax ranks of the goal
+    SyntaxDAG::Ranks ranks;
+    bool hasranks;
+    // Weight of the goal, by contexts of weight key weightkey
+    Weight weight;
+    std::size_t weightkey;
+    bool hasweight;
+    // CNF of the negated goal, in the context of id negCNFid.
+    // Only the last context is kept, as a goal is checked in one at a time.
+    CNFClauses negCNF;
+    std::size_t negCNFid;
+    bool hasnegCNF;
+    // Fingerprint of the goal, if okay
+    Fingerprint fp;
+    bool hasfp, fpokay;
+    // BDD of the goal, none() if not okay, in the BDDs of id bddsid
+    BDDs::Ref bdd;
+    std::size_t bddsid;
+    Goalcache() { clear(); }
+    Goalcache(Goalcache const &) { clear(); }
+    Goalcache & operator=(Goalcache const &) { clear(); return *this; }
+    void clear()
+    {
+        ast.clear();
+        maxabs.clear(); hasmaxabs = false;
+        ranks.clear(); hasranks = false;
+        hasweight = false;
+        negCNF.clear(); hasnegCNF = false;
+        hasfp = fpokay = false;
+        bdd = BDDs::none(); bddsid = 0;
+    }
+};
+
 // Proof goal
 typedef std::pair<RPN const &, strview> Goalview;
 struct Goal
 {
     RPN rpn;
     strview typecode;
-    AST mutable ast;
+    Goalcache mutable cache;
     Goal() : rpn(), typecode("") {}
     Goal(Goalview view) : rpn(view.first), typecode(view.second) {}
-    void fillast() const { if (ast.empty()) ast = ::ast(rpn); }
     RPNsize size() const { return rpn.size(); }
-    operator RPNspanAST() const
-    { fillast(); return RPNspanAST(rpn, ast); }
+    // AST of the goal
+    AST const & ast() const
+    {
+        if (cache.ast.empty())
+            cache.ast = ::ast(rpn);
+        return cache.ast;
+    }
+    operator RPNspanAST() const { return RPNspanAST(rpn, ast()); }
+    // Maximal abstractions of the goal
+    GovernedRPNspansbystep const & maxabs() const
+    {
+        if (!cache.hasmaxabs)
+            cache.maxabs = ::maxabs(*this), cache.hasmaxabs = true;
+        return cache.maxabs;
+    }
+    // Syntax ranks of the goal
+    SyntaxDAG::Ranks const & ranks(SyntaxDAG const & syntaxDAG) const
+    {
+        if (!cache.hasranks)
+            cache.ranks = syntaxDAG.RPNranks(rpn), cache.hasranks = true;
+        return cache.ranks;
+    }
     Expression expression() const
     {
         Expression result(verify(rpn));
@@ -33,7 +98,7 @@ inline bool operator<(Goal const & x, Goal const & y)
 {
     int const cmp
     = util::compare(x.rpn.begin(), x.rpn.end(), y.rpn.begin(), y.rpn.end());
-    return cmp < 0 || cmp == 0 && x.typecode < y.typecode;
+    return cmp < 0 || (cmp == 0 && x.typecode < y.typecode);
 }
 
 // Hash for goals
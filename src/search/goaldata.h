@@ -32,8 +32,8 @@ pEnvs const & supEnvs(Environ const & env);
 struct Goaldatas : std::map<Environ const *, class Goaldata>
 {
     // Proof that holds in the problem context
-    RPN proof;
-    bool proven() const { return !proof.empty(); }
+    pProofnode proof;
+    bool proven() const { return static_cast<bool>(proof); }
 };
 
 // Map: goal -> context -> evaluation
@@ -44,7 +44,7 @@ typedef Goals::pointer pBIGGOAL;
 class Goaldata
 {
     Goalstatus status;
-    RPN proof;
+    pProofnode proof;
     // Set of pointers to nodes trying to prove the open goal
     pNodes m_pnodes;
 public:
@@ -59,12 +59,13 @@ public:
     Goal const & goal() const { return pbigGoal->first; }
     Goaldatas & goaldatas() const { return pbigGoal->second; }
     // Source of proof to be read from
-    RPN const & proofsrc() const
+    pProofnode const & proofsrc() const
     { return goaldatas().proven() ? goaldatas().proof : proof; }
-    RPN const & proofsrc()
+    pProofnode const & proofsrc()
     {
-        RPN const & proof0 = const_cast<Goaldata const *>(this)->proofsrc();
-        if (!proof0.empty()) return proof0;
+        pProofnode const & proof0
+            = const_cast<Goaldata const *>(this)->proofsrc();
+        if (proof0) return proof0;
         if (subsumedbyProb(*pEnv)) return proof;
 
         // Sub-contexts of env
@@ -74,7 +75,7 @@ public:
         
         // Loop through sub-contexts.
         FOR (Goaldatas::const_reference goaldata, goaldatas())
-            if (!goaldata.second.proof.empty() && !subsumedbyProb(*goaldata.first))
+            if (goaldata.second.proof && !subsumedbyProb(*goaldata.first))
             {
                 Environ const & otherEnv = *goaldata.first;
                 subiter = std::lower_bound(subiter, subend, &otherEnv, less);
@@ -88,10 +89,10 @@ public:
         
         return proof;
     }
-    bool proven() const { return !proofsrc().empty(); }
-    bool proven() { return !proofsrc().empty(); }
+    bool proven() const { return static_cast<bool>(proofsrc()); }
+    bool proven() { return static_cast<bool>(proofsrc()); }
     // Destination to write proof to
-    RPN & proofdst()
+    pProofnode & proofdst()
     { return subsumedbyProb(*pEnv) ? goaldatas().proof : proof; }
     // Pointers to nodes trying to prove this goal
     pNodes const & pnodes() const { return m_pnodes; }
@@ -3,7 +3,6 @@
 #include "move.h"
 #include "../util/for.h"
 #include "../io.h"
-#include "../proof/write.h"
 
 static Symbol3s symbols(RPN const & exp)
 {
@@ -16,17 +15,46 @@ static Symbol3s symbols(RPN const & exp)
     return set;
 }
 
+// Mask of the variables in a substitution, computed once.
+// state = 1 if okay, -1 if not, 0 if not computed.
+// Return NULL if a variable is not in the statement.
+static Varmask const * substmask
+    (DVmatrix const & DV, RPN const & subst,
+     Varmask & mask, signed char & state)
+{
+    if (state == 0)
+        state = DV.mask(subst, mask) ? 1 : -1;
+    return state > 0 ? &mask : NULL;
+}
+
 // Return true if a move satisfies disjoint variable hypotheses.
-bool Move::checkDV(Assertion const & ass, bool verbose) const
+bool Move::checkDV
+    (Assertion const & ass, DVmatrix const & DV, bool verbose) const
 {
     if (!pthm)
         return true;
 
+    // Masks of substitutions, by variable id
+    std::vector<Varmask> masks(substitutions.size());
+    std::vector<signed char> states(substitutions.size());
+
     FOR (Disjvars::const_reference vars, theorem().disjvars)
     {
         RPN const & RPN1 = substitutions[vars.first];
         RPN const & RPN2 = substitutions[vars.second];
 
+        Varmask const * const pmask1
+            = substmask(DV, RPN1, masks[vars.first], states[vars.first]);
+        Varmask const * const pmask2
+            = substmask(DV, RPN2, masks[vars.second], states[vars.second]);
+        if (pmask1 && pmask2)
+        {
+            if (DV.check(*pmask1, *pmask2))
+                continue;
+            if (!verbose)
+                return false;
+        }
+        // Check by symbols, reporting any violation.
         if (!::checkDV
             (symbols(RPN1),symbols(RPN2),ass.disjvars,ass.varusage,verbose))
             return false;
@@ -41,20 +69,34 @@ Disjvars Move::findDV(Assertion const & ass) const
     Disjvars result;
 
     Varusage const & varusage = ass.varusage;
+    DVmatrix const DV(ass.disjvars, varusage);
+
+    // Masks of abstractions, in varusage order
+    std::vector<Varmask> masks(varusage.size());
+    Bvector hasmask(varusage.size());
+    Varusage::size_type i = 0;
+    FOR (Varusage::const_reference var, varusage)
+    {
+        hasmask[i] = DV.mask(abstraction(var.first), masks[i]);
+        ++i;
+    }
 
+    i = 0;
     for (Varusage::const_iterator iter1 = varusage.begin(); 
-         iter1 != varusage.end(); ++iter1)
+         iter1 != varusage.end(); ++iter1, ++i)
     {
         Symbol3 var1 = iter1->first;
         RPN const & RPN1 = abstraction(var1);
 
+        Varusage::size_type j = i + 1;
         Varusage::const_iterator iter2 = iter1;
-        for (++iter2; iter2 != varusage.end(); ++iter2)
+        for (++iter2; iter2 != varusage.end(); ++iter2, ++j)
         {
             Symbol3 var2 = iter2->first;
             RPN const & RPN2 = abstraction(var2);
 
-            if (::checkDV
+            if (hasmask[i] && hasmask[j] ? DV.check(masks[i], masks[j]) :
+                ::checkDV
                 (symbols(RPN1),symbols(RPN2),ass.disjvars,ass.varusage, false))
                 result.insert(std::make_pair(var1, var2));
         }
@@ -63,12 +105,12 @@ Disjvars Move::findDV(Assertion const & ass) const
     return result;
 }
 
-// Return pointer to proof of subgoal. Return nullptr if out of bound.
-pProof Move::psubgoalproof(Hypsize index) const
+// Return proof of subgoal.
+// Return the null pointer if out of bound or floating.
+pProofnode Move::subgoalproof(Hypsize index) const
 {
-    return index >= nsubgoals() ? pProof() :
-            subgoalfloats(index) ? &substitutions[hypvar(index)] :
-            &static_cast<pGoal>(subgoals[index])->second.proofsrc();
+    return index >= nsubgoals() || subgoalfloats(index) ? pProofnode() :
+            static_cast<pGoal>(subgoals[index])->second.proofsrc();
 }
 
 // Size of a substitution
@@ -109,60 +151,52 @@ void Move::makesubst(RPN const & src, RPN & dest) const
     }
 }
 
-// Size of full proof (must be of type CONJ)
-RPNsize Move::fullproofsize(pProofs const & phyps) const
+static void writeprooferr(strview label, std::string const & hyplabel)
 {
-    if (phyps.empty() || !phyps.back())
-        return 0;
+    std::cerr << "When writing proof using " << label;
+    std::cerr << ", hypothesis " << hyplabel << " has no proof" << std::endl;
+}
 
-    RPNsize sum = 0;
-    FOR (RPNstep step, *phyps.back())
-        switch (step.type)
+// Write proof using the theorem (must be of type THM).
+pProofnode Move::writethmproof() const
+{
+    Proofnode * const p = new Proofnode;
+    pProofnode const result(p);
+
+    for (Hypsize i = 0; i < nsubgoals(); ++i)
+        if (subgoalfloats(i))
         {
-        case RPNstep::THM:
-            ++sum;
-            break;
-        case RPNstep::HYP:
-            if (step.phyp->second.floats)
-                if (RPNsize size = substitutions[step.id()].size())
-                    sum += size;
-                else
-                    ++sum;
-            else
-            {
-                Hypsize const index = findabsconj(step.phyp->second);
-                if (index >= nconjs())
-                    ++sum;
-                else if (!phyps[index] || phyps[index]->empty())
-                    return 0;
-                else
-                    sum += phyps[index]->size();
-            }
+            RPN const & subst = substitutions[hypvar(i).id];
+            if (subst.empty())
+                return writeprooferr(label(), subgoallabel(i)), pProofnode();
+            p->append(subst);
         }
-    return sum;
+        else if (!p->append(subgoalproof(i)))
+            return writeprooferr(label(), subgoallabel(i)), pProofnode();
+    // Label of the assertion used
+    p->push_back(pthm);
+    // Verify the new step only.
+    p->conclusion = p->verify();
+
+    return result;
 }
 
-// Write proof.
-bool Move::writeproof(RPN & dest, pProofs const & phyps) const
+// Write proof from that of the abstraction (must be of type CONJ).
+pProofnode Move::writeconjproof() const
 {
-    if (pthm)
-        return ::writeproof(dest, pthm, phyps);
-    if (!isconj())
-        return false;
-    // type CONJ
-    dest.clear();
+    // Proof of the abstract goal, in the context with conjectures
+    RPN const & absproof = flatten(subgoalproof(nconjs()));
+    if (absproof.empty())
+        return pProofnode();
 
-    RPNsize const size = fullproofsize(phyps);
-    if (size == 0)
-        return false;
-    // Preallocate for efficiency.
-    dest.reserve(size);
+    Proofnode * const p = new Proofnode;
+    pProofnode const result(p);
 
-    FOR (RPNstep step, *phyps.back())
+    FOR (RPNstep step, absproof)
         switch (step.type)
         {
         case RPNstep::THM:
-            dest.push_back(step);
+            p->push_back(step);
             break;
         case RPNstep::HYP:
             if (step.phyp->second.floats)
@@ -170,23 +204,31 @@ bool Move::writeproof(RPN & dest, pProofs const & phyps) const
                 // Floating hypothesis. Check if it refers to an abstract var.
                 RPN const & subst = substitutions[step.id()];
                 if (!subst.empty())
-                    dest += subst; // Abstract variable
+                    p->append(subst); // Abstract variable
                 else
-                    dest.push_back(step); // Concrete variable
+                    p->push_back(step); // Concrete variable
             }
             else
             {
                 // Essential hypothesis. Check if it is abstract.
                 Hypsize const index = findabsconj(step.phyp->second);
                 if (index >= nconjs())
-                    dest.push_back(step); // Concrete hypothesis
-                else
-// printconj(), std::cin.get(),
-                    dest += *phyps[index];// Abstract hypothesis
+                    p->push_back(step); // Concrete hypothesis
+                else if (!p->append(subgoalproof(index)))
+                    return pProofnode(); // Abstract hypothesis unproven
             }
         }
-    
-    return true;
+    // Verify the new steps only.
+    p->conclusion = p->verify();
+
+    return result;
+}
+
+// Write proof, sharing the proofs of sub-goals, and verify it.
+// Return the null pointer if not okay.
+pProofnode Move::writeproof() const
+{
+    return pthm ? writethmproof() : isconj() ? writeconjproof() : pProofnode();
 }
 
 void Move::printconj() const
@@ -3,7 +3,9 @@
 
 #include "../ass.h"
 #include "../bank.h"
+#include "../disjvars.h"
 #include "goal.h"
+#include "../proof/dag.h"
 #include "../util/hex.h"
 
 static const std::string strconj = "CONJ";
@@ -84,7 +86,8 @@ struct Move
         return result;
     }
     // Return true if a move satisfies disjoint variable hypotheses.
-    bool checkDV(Assertion const & ass, bool verbose = false) const;
+    bool checkDV(Assertion const & ass, DVmatrix const & DV,
+                 bool verbose = false) const;
     // Find the disjoint variable hypotheses of a CONJ move.
     Disjvars findDV(Assertion const & ass) const;
     Symbol3 hypvar(Hypsize index) const
@@ -145,8 +148,9 @@ struct Move
                 return i;
         return i;
     }
-    // Return pointer to proof of subgoal. Return nullptr if out of bound.
-    pProof psubgoalproof(Hypsize index) const;
+    // Return proof of subgoal.
+    // Return the null pointer if out of bound or floating.
+    pProofnode subgoalproof(Hypsize index) const;
     // # of conjectures made
     Hypsize nconjs() const { return isconj() * (absconjs.size() - 1); }
     // Abstract variables in use (must be of type CONJ)
@@ -190,24 +194,19 @@ struct Move
         }
         return nconjs();
     }
-    // Pointers to proofs of sub-goals
-    pProofs phyps() const
-    {
-        pProofs result(nsubgoals());
-        for (Hypsize i = 0; i < result.size(); ++i)
-            result[i] = psubgoalproof(i);
-        return result;
-    }
 private:
     // Size of a substitution
     RPNsize substsize(RPN const & src) const;
     // Make a substitution.
     void makesubst(RPN const & src, RPN & dest) const;
-    // Size of full proof (must be of type CONJ)
-    RPNsize fullproofsize(pProofs const & phyps) const;
+    // Write proof using the theorem (must be of type THM).
+    pProofnode writethmproof() const;
+    // Write proof from that of the abstraction (must be of type CONJ).
+    pProofnode writeconjproof() const;
 public:
-    // Write proof.
-    bool writeproof(RPN & dest, pProofs const & phyps) const;
+    // Write proof, sharing the proofs of sub-goals, and verify it.
+    // Return the null pointer if not okay.
+    pProofnode writeproof() const;
     // Print a CONJ move.
     void printconj() const;
 };
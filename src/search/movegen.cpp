@@ -57,8 +57,8 @@ Moves Environ::ourmoves(Game const & game, stage_t stage) const
     Goal const & goal = game.goal();
     // Check goal type code.
     Theorempools const & pools = prob().database.theorempools();
-    Theorempools::const_iterator const iter = pools.find(goal.typecode);
-    if (iter == pools.end())
+    Theorempool const * const pool = pools.find(goal.typecode);
+    if (!pool)
         return Moves();
     // Problem assertion #
     nAss & limit = pProb->numberlimit;
@@ -66,7 +66,7 @@ Moves Environ::ourmoves(Game const & game, stage_t stage) const
     if (limit > assnum())
         limit = assnum();
     // Theorems to be tried
-    Assiters const & assvec = iter->second.matches(goal, limit);
+    Assiters const & assvec = pool->matches(goal, limit);
     // Assiters const & assvec = prob().database.assiters();
     // Prepare term generator
     initGen();
@@ -83,7 +83,7 @@ Moves Environ::ourmoves(Game const & game, stage_t stage) const
             (ass.nfreevar() > 0 && stage >= ass.nfreevar()))
         {
             RPNspans subst(ass.maxvarid + 1);
-            if (findsubst(goal, ass.expRPNAST(), subst)
+            if (findsubst(goal, ass.expmatcher, subst)
                 && addmoves(assiter, subst, stage, moves))
                 return moves;
         }
@@ -133,7 +133,7 @@ bool Environ::addhypmoves(pAss pthm, Moves & moves,
             // Match hypothesis asshyp against key hypothesis thmhyp of the theorem.
             RPNspans newsubsts(substs);
             if (findsubst
-                (assertion.hypRPNAST(asshyp), thm.hypRPNAST(thmhyp), newsubsts))
+                (assertion.hypRPNAST(asshyp), thm.hypmatcher(thmhyp), newsubsts))
 // std::cout << assertion.hyplabel(asshyp) << ' ' << assertion.hypexp(asshyp),
                 if (addboundmove(Move(pthm, newsubsts), moves))
                     return true;
@@ -145,7 +145,7 @@ bool Environ::addhypmoves(pAss pthm, Moves & moves,
 // Add abstraction moves. Return true if it has no open hypotheses.
 bool Environ::addabsmoves(Game const & game, Moves & moves) const
 {
-    GovernedRPNspansbystep const & abs = maxabs(game.goal());
+    GovernedRPNspansbystep const & abs = game.goal().maxabs();
 
     FOR (GovernedRPNspansbystep::const_reference rstep, abs)
         FOR (GovernedRPNspans::const_reference subexp, rstep.second)
@@ -176,22 +176,19 @@ bool Environ::addabsmoves
 }
 
 static void addabsubst
-    (RPNspanAST subexp, Symbol3 absvar, pAss pass,
+    (RPNspanAST subexp, Symbol3 absvar, Absentry const & entry,
      Absubstmoves & absubstmoves)
 {
+    pAss const pass = entry.first;
     Assertion const & ass = pass->second;
     RPNspans subst(ass.maxvarid + 1);
-    GovernedRPNspansbystep::const_iterator const iter =
-    ass.expmaxabs.find(subexp.first.root());
-    if (iter == ass.expmaxabs.end())
-        return;
+    GovernedRPNspans const & spans = *entry.second;
 
-    absubstmoves.reserve(absubstmoves.size() + iter->second.size());
-    FOR (GovernedRPNspans::const_reference thmabs, iter->second)
+    absubstmoves.reserve(absubstmoves.size() + spans.size());
+    FOR (GovernedRPNspans::const_reference thmabs, spans)
     {
         subst.assign(subst.size(), RPNspan());
-        RPNspanAST thmabsAST(thmabs.first, thmabs.second);
-        if (findsubst(subexp, thmabs, subst))
+        if (findsubst(subexp, thmabs.first, subst))
         {
             absubstmoves.push_back(std::make_pair(Move(pass, subst), RPN()));
             Move const & move = absubstmoves.back().first;
@@ -212,12 +209,27 @@ Absubstmoves Environ::absubsts(RPNspanAST subexp) const
 {
     Absubstmoves moves;
 
+    nAss const limit = prob().numberlimit;
+    // Add the abstract variable if any assertion is usable as a conjecture.
     Assiters const & assvec = prob().database.assiters();
-    for (nAss i = 1; i < prob().numberlimit; ++i)
+    nAss i = 1;
+    while (i < limit && !usableasconj(assvec[i]->second))
+        ++i;
+    if (i >= limit)
+        return moves;
+    Symbol3 const absvar = pProb->bank.addabsvar(subexp.first);
+    // Assertions with spans governed by the root of the sub-expression
+    Absindex const & index = prob().database.absindex();
+    Absindex::const_iterator const iter = index.find(subexp.first.root());
+    if (iter == index.end())
+        return moves;
+
+    FOR (Absentry const & entry, iter->second)
     {
-        Assiter const iter = assvec[i];
-        if (usableasconj(iter->second))
-            addabsubst(subexp, pProb->bank.addabsvar(subexp.first), &*iter, moves);
+        if (entry.first->second.number >= limit)
+            break;
+        if (usableasconj(entry.first->second))
+            addabsubst(subexp, absvar, entry, moves);
     }
 
     return moves;
@@ -35,7 +35,7 @@ static int next(Hypsizes & hypstack, std::vector<RPNspans> & substack,
             if (asshyp == ass.nhyps())
                 return delta; // No new match
             if (findsubst
-                (ass.hypRPNAST(asshyp), thm.hypRPNAST(thmhyp),
+                (ass.hypRPNAST(asshyp), thm.hypmatcher(thmhyp),
                  substack[hypstack.size()]))
                 return ++delta; // New match
         }
@@ -15,7 +15,7 @@ Environ const & Problem::addhypproofs(Environ const & env)
     {
         if (ass.hypfloats(i)) continue;
         addgoal(Goalview(ass.hypRPN(i), ass.hyptypecode(i)), env, GOALTRUE)
-        ->second.proofdst().assign(1, ass.hypptr(i));
+        ->second.proofdst() = makeproof(RPN(1, ass.hypptr(i)));
     }
     return env;
 }
@@ -50,6 +50,8 @@ Environ const * Problem::initEnv(Environ * p)
     p->maxranks = database.hypsmaxranks(p->assertion);
     p->pProb = this;
     p->m_subsumedbyProb = nEnvs() <= 1 || probEnv().implies(*p);
+    // Compare with the current maxranks, as reval only updates the
+    // contexts when maxranks changes.
     updateimps(*p);
 
     if (!p->subsumedbyProb())
@@ -5,6 +5,7 @@
 #include "environ.h"
 #include "../proof/compspan.h"
 #include "../util/for.h"
+#include "../util/incl.h"
 
 inline bool operator<(Hypiters const & x, Hypiters const & y)
 {
@@ -56,6 +57,8 @@ private:
     SyntaxDAG::Ranks maxranks;
     // Max # of rank in maxranks
     nAss maxranknumber;
+    // rankcounts[rank] = # almost-won leaves using the rank
+    std::vector<std::size_t> rankcounts;
 public:
     // Problem context
     Environ const * const pProbEnv;
@@ -132,19 +135,29 @@ public:
     // Called after each playonce()
     virtual void playoncecallback();
 // Reval
-    // Add the ranks of a node to maxranks, if almost won.
-    void addranks(pNode p);
-    // Prune the sub-tree at p and update maxranks, if almost won.
+    // Mark a node and its ancestors as changed since the last reval.
+    static void setchanged(pNode p)
+    {
+        for ( ; p && !p->game().changed; p = p.parent())
+            p->game().changed = true;
+    }
+    // Count or uncount the ranks of a node in rankcounts.
+    void countranks(pNode p, bool counted);
+    // Max ranks of almost-won leaves
+    SyntaxDAG::Ranks leafmaxranks() const;
+    // Prune the changed part of the sub-tree at p
+    // and count the ranks of almost-won leaves.
     void prune(pNode p);
     // Update implications after problem context is simplified.
     void updateimps(Environ const & env);
     void updateimps();
     // Focus the sub-tree at p, with updated maxranks, if almost won.
+    // Re-evaluate every almost-won leaf, leaving marked only what changed.
     void focus(pNode p);
     // Refocus the tree on simpler sub-tree, if almost won.
     void reval();
-    // Proof of the assertion, if not empty
-    RPN const & proof() const { return root()->game().proof(); }
+    // Flattened proof of the assertion, if not empty
+    RPN proof() const { return flatten(root()->game().proof()); }
     // Return true if proof() solves the problem *iter.
     bool checkproof(Assiter iter) const;
 // Stats
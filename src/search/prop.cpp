@@ -13,18 +13,88 @@ struct Substadder : Adder
     Expression const & freevars;
     Moves & moves;
     Move & move;
-    Environ const & env;
+    Prop const & env;
+    // Fingerprints of variables after substitution, by id
+    Fingerprints varfps;
+    // Essential hypotheses of the theorem containing free variables
+    std::vector<Hypsize> freehyps;
+    // Scratch stack for fingerprint evaluation
+    Fingerprints fpstack;
+    // True if fingerprints can be used to refute moves
+    bool usefps;
+    // True if a hypothesis without free variables is refuted
+    bool refutedwithoutfreevars;
     Substadder
     (Expression const & freevars, Moves & moves, Move & move,
-        Environ const & env) :
-        freevars(freevars), moves(moves), move(move), env(env) {}
+        Prop const & env) :
+        freevars(freevars), moves(moves), move(move), env(env),
+        usefps(env.hashypsfp()), refutedwithoutfreevars(false)
+    {
+        Assertion const & thm = move.theorem();
+        // Fingerprints of the context variables
+        Fingerprints const & ctxfps(env.ctxvarfps());
+        // Fingerprints of the theorem variables
+        Symbol2::ID const n
+            = std::max<Symbol2::ID>(thm.maxvarid + 1, move.substitutions.size());
+        varfps.assign(env.varfps(n).begin(), env.varfps(n).begin() + n);
+        for (Symbol2::ID id = 1; id < move.substitutions.size() && usefps; ++id)
+            if (!move.substitutions[id].empty())
+                usefps = env.propctors.fingerprint
+                (move.substitutions[id], ctxfps, fpstack, varfps[id]);
+        // Hypotheses containing free variables
+        Bvector hasfreevar(thm.nhyps(), false);
+        FOR (Varusage::const_reference var, thm.varusage)
+            if (!var.second.back())
+                for (Hypsize i = 0; i < thm.nhyps(); ++i)
+                    hasfreevar[i] = hasfreevar[i] || var.second[i];
+        for (Hypsize i = 0; i < thm.nhyps() && usefps; ++i)
+        {
+            if (thm.hypfloats(i)) continue;
+            if (hasfreevar[i])
+            {
+                freehyps.push_back(i);
+                continue;
+            }
+            Fingerprint fp;
+            usefps = env.propctors.fingerprint(thm.hypRPN(i), varfps, fpstack, fp);
+            refutedwithoutfreevars |= usefps && !env.hypsfp().implies(fp);
+        }
+    }
+    // Return true if a subgoal is falsified where the hypotheses hold,
+    // as seen from the fingerprints.
+    bool refuted(Argtypes const & types, Genstack const & stack)
+    {
+        if (!usefps)
+            return false;
+        if (refutedwithoutfreevars)
+            return true;
+        for (RPNsize i = 0; i < types.size(); ++i)
+        {
+            Fingerprint const * const p = env.termfp(types[i], stack[i]);
+            if (!p)
+                return false;
+            varfps[freevars[i]] = *p;
+        }
+        Assertion const & thm = move.theorem();
+        Fingerprint fp;
+        FOR (Hypsize i, freehyps)
+            if (env.propctors.fingerprint(thm.hypRPN(i), varfps, fpstack, fp) &&
+                !env.hypsfp().implies(fp))
+                return true;
+        return false;
+    }
     // Add a move. Return true if the move closed the goal.
     bool operator()(Argtypes const & types, Genresult const & result,
                     Genstack const & stack)
     {
+        // Filter move by fingerprints.
+        if (refuted(types, stack))
+            return false;
         for (RPNsize i = 0; i < types.size(); ++i)
-            move.substitutions[freevars[i]] =
-            result.at(freevars[i].typecode())[stack[i]];
+        {
+            RPNspan const term = result[types[i]][stack[i]];
+            move.substitutions[freevars[i]].assign(term.first, term.second);
+        }
         // Filter move by SAT.
         switch (env.valid(move))
         {
@@ -54,16 +124,17 @@ bool Prop::addhardmoves(Move & move, RPNsize size, Moves & moves) const
     Assertion const & thm = pthm->second;
     // Free variables in the theorem to be used
     Expression freevars;
-    // Type codes of free variables
+    // Types of free variables
     Argtypes types;
     // Preallocate for efficiency.
     freevars.reserve(thm.nfreevar()), types.reserve(thm.nfreevar());
     FOR (Varusage::const_reference var, thm.varusage)
         if (!var.second.back())
-            freevars.push_back(var.first), types.push_back(var.first.typecode());
+            freevars.push_back(var.first),
+            types.push_back(typenum(var.first.typecode()));
     // Generate substitution terms.
-    FOR (Symbol3 var, freevars)
-        generateupto(var.typecode(), size);
+    FOR (Typenum type, types)
+        generateupto(type, size);
     // Generate substitutions.
     Substadder adder(freevars, moves, move, *this);
     dogenerate(types, size + 1, adder);
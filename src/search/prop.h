@@ -14,10 +14,10 @@
 struct Prop : Environ
 {
     Prop(Assertion const & ass, Propctors const & propctors,
-         double wfactor = 0, std::size_t maxsize = -1) :
+         double wfactor = 0, std::size_t maxsize = -1, BDDs * pbdds = NULL) :
         Environ(ass, maxsize), propctors(propctors),
         allhypsCNF(propctors.hypscnf(ass, hypnatoms)),
-        weightfactor(wfactor)
+        weightfactor(wfactor), m_bdds(pbdds ? *pbdds : m_ownbdds)
     {
 // std::cout << "newEnv " << label << ' ' << ass.varusage;
 // std::cout << hasnewvarinexp << std::endl;
@@ -26,6 +26,33 @@ struct Prop : Environ
         hypsweight = 0;
         for (Hypsize i = 0; i < ass.nhyps(); ++i)
             hypsweight += weight(ass.hypRPN(i));
+        // Max id of variables in the context
+        m_maxvarid = 0;
+        FOR (Varusage::const_reference var, ass.varusage)
+            m_maxvarid = std::max(m_maxvarid, var.first.id);
+        // Fingerprint of all essential hypotheses combined
+        m_hypsfp = ~Fingerprint();
+        m_hashypsfp = true;
+        for (Hypsize i = 0; i < ass.nhyps() && m_hashypsfp; ++i)
+        {
+            if (ass.hypfloats(i)) continue;
+            Fingerprint fp;
+            m_hashypsfp = propctors.fingerprint
+            (ass.hypRPN(i), ctxvarfps(), m_fpstack, fp);
+            m_hypsfp &= fp;
+        }
+        // BDDs of essential hypotheses, top for floating ones
+        m_hypBDDs.assign(ass.nhyps(), BDDs::top());
+        m_hypsBDD = BDDs::top();
+        m_hashypsBDD = true;
+        for (Hypsize i = 0; i < ass.nhyps() && m_hashypsBDD; ++i)
+        {
+            if (ass.hypfloats(i)) continue;
+            m_hashypsBDD = propctors.bdd
+            (ass.hypRPN(i), m_bdds, m_bddstack, m_hypBDDs[i]);
+            m_hypsBDD = m_bdds.conj(m_hypsBDD, m_hypBDDs[i]);
+            m_hashypsBDD &= m_hypsBDD != BDDs::none();
+        }
     }
     // Return true if an assertion is on topic/useful.
     virtual bool ontopic(Assertion const & ass) const
@@ -33,57 +60,123 @@ struct Prop : Environ
     // CNF of a goal. # of atoms starts from hypnatoms
     CNFClauses goalCNF(Goal const & goal, bool const neg = false) const
     {
-        goal.fillast();
         CNFClauses cnf;
         // Add and negate Conclusion.
         Atom n = hypnatoms;
         if (propctors.addformula
-            (goal.rpn, goal.ast, assertion.hypiters, cnf, n))
+            (goal.rpn, goal.ast(), assertion.hypiters, cnf, n))
             cnf.closeoff(n - 1, neg);
         else
             cnf.clear();
         return cnf;
     }
+    // CNF of the negated goal, kept for the last context it is built in
+    CNFClauses const & negCNF(Goal const & goal) const
+    {
+        Goalcache & cache = goal.cache;
+        if (!cache.hasnegCNF || cache.negCNFid != id)
+        {
+            cache.negCNF = goalCNF(goal, true);
+            cache.negCNFid = id;
+            cache.hasnegCNF = true;
+        }
+        return cache.negCNF;
+    }
+    // BDD of a goal, built once per BDDs shared by the contexts.
+    // Return NULL if not okay.
+    BDDs::Ref const * goalBDD(Goal const & goal) const
+    {
+        Goalcache & cache = goal.cache;
+        if (cache.bddsid != m_bdds.id)
+        {
+            if (!propctors.bdd(goal.rpn, m_bdds, m_bddstack, cache.bdd))
+                cache.bdd = BDDs::none();
+            cache.bddsid = m_bdds.id;
+        }
+        return cache.bdd != BDDs::none() ? &cache.bdd : NULL;
+    }
+    // Fingerprint of a goal, computed once. Return NULL if not okay.
+    Fingerprint const * goalfp(Goal const & goal) const
+    {
+        Goalcache & cache = goal.cache;
+        if (!cache.hasfp)
+        {
+            // Variable fingerprints are fixed by id, so do not depend on
+            // the context.
+            Symbol2::ID maxid = 0;
+            FOR (RPNstep step, goal.rpn)
+                maxid = std::max(maxid, step.id());
+            cache.fpokay = propctors.fingerprint
+            (goal.rpn, varfps(maxid + 1), m_fpstack, cache.fp);
+            cache.hasfp = true;
+        }
+        return cache.fpokay ? &cache.fp : NULL;
+    }
     // Determine status of a goal.
     virtual Goalstatus status(Goal const & goal) const
     {
-        CNFClauses const & conclusion(goalCNF(goal, true));
+        // Refuted if a sampled assignment satisfies the hypotheses
+        // but not the goal
+        Fingerprint const * const pfp = goalfp(goal);
+        if (pfp && m_hashypsfp && !m_hypsfp.implies(*pfp))
+            return GOALFALSE;
+        BDDs::Ref const * const pgoal = goalBDD(goal);
+        if (pgoal && m_hashypsBDD)
+        {
+            Tribool const implied = m_bdds.implies(m_hypsBDD, *pgoal);
+            if (implied != UNKNOWN)
+                return implied == TRUE ? GOALTRUE : GOALFALSE;
+        }
+        CNFClauses const & conclusion(negCNF(goal));
         return conclusion.empty() ? printbadgoal(goal.rpn) :
                 allhypsCNF.first.sat(conclusion) ? GOALFALSE : GOALTRUE;
     }
-    // Return the CNF with some hypotheses trimmed
-    CNFClauses hypsCNF(Bvector const & hypstotrim) const
+    // Return views of the CNF with some hypotheses trimmed
+    CNFSlices hypsCNF(Bvector const & hypstotrim) const
     {
         CNFClauses const & hyps = allhypsCNF.first;
         if (!util::filter(hypstotrim)(true))
-            return hyps;
-        CNFClauses cnf;
+            return CNFSlices(1, hyps.slice());
+        CNFSlices slices;
         Proofnumbers const & ends = allhypsCNF.second;
         for (Hypsize j = 0; j < nhyps(); ++j)
             if (!assertion.hypfloats(j) && !hypstotrim[j]) // Not floating nor trimmed
 // std::cout << "Adding hypothesis " << assertion.hyplabel(j) << std::endl,
-                cnf.insert(cnf.end(),
-                    &hyps[j ? ends[j - 1] : 0], &hyps[ends[j]]);
-// std::cout << "hypcnf\n" << allhypsCNF.first << "cnf\n" << cnf;
-        return cnf;
+                slices.push_back(hyps.slice(j ? ends[j - 1] : 0, ends[j]));
+        return slices;
+    }
+    // Return true if the hypotheses not trimmed imply a goal.
+    bool implies(Bvector const & hypstotrim, Goal const & goal) const
+    {
+        BDDs::Ref const * const pgoal = goalBDD(goal);
+        if (pgoal && m_hashypsBDD)
+        {
+            BDDs::Ref hyps = BDDs::top();
+            for (Hypsize j = 0; j < nhyps(); ++j)
+                if (!hypstotrim[j])
+                    hyps = m_bdds.conj(hyps, m_hypBDDs[j]);
+            Tribool const implied = m_bdds.implies(hyps, *pgoal);
+            if (implied != UNKNOWN)
+                return implied == TRUE;
+        }
+        CNFSlices slices(hypsCNF(hypstotrim));
+        slices.push_back(negCNF(goal).slice());
+        return !satisfiable(slices);
     }
     // Return the hypotheses of a goal to trim.
     virtual Bvector hypstotrim(Goal const & goal) const
     {
         Bvector result(nhyps(), false);
-        CNFClauses conclusion;
         // True if a floating hypothesis could be trimmed.
         bool trimmed = hasnewvarinexp;
         // Check for essential hypotheses to be trimmed.
         for (Hypsize i = nhyps() - 1; i != static_cast<Hypsize>(-1); --i)
         {
             if (assertion.hypfloats(i)) continue;
-            // Add conclusion if not already there.
-            if (conclusion.empty()) conclusion = goalCNF(goal, true);
 // std::cout << "Trimming hypothesis " << assertion.hyplabel(i) << std::endl;
             result[i] = true;
             // If the conclusion still holds, the hypothesis can be trimmed.
-            trimmed |= (result[i] = !hypsCNF(result).sat(conclusion));
+            trimmed |= (result[i] = implies(result, goal));
         }
         // return assertion.trimvars(result, goal.rpn);
         return trimmed ? assertion.trimvars(result, goal.rpn) : Bvector();
@@ -94,6 +187,9 @@ struct Prop : Environ
         Weight n = assnum();
         return n/(n - step.pass->second.number);
     }
+    // Contexts sharing BDDs are made from one another,
+    // with the same assertion number and weight factor.
+    virtual std::size_t weightkey() const { return m_bdds.id; }
     // Weight of the goal
     virtual Weight weight(RPN const & goal) const
     {
@@ -111,10 +207,40 @@ struct Prop : Environ
     {
         if (!pProb) return NULL;
         return new(std::nothrow)
-        Prop(ass, propctors, weightfactor, m_maxmoves);
+        Prop(ass, propctors, weightfactor, m_maxmoves, &m_bdds);
     }
     // Propositional syntax constructors
     Propctors const & propctors;
+    // Fingerprints of variables by id, at least up to id n - 1
+    Fingerprints const & varfps(Symbol2::ID n) const
+    {
+        while (m_varfps.size() < n)
+            m_varfps.push_back(Fingerprint::random(m_varfps.size()));
+        return m_varfps;
+    }
+    // Fingerprints of the variables in the context by id
+    Fingerprints const & ctxvarfps() const { return varfps(m_maxvarid + 1); }
+    // Return true if the hypotheses have a fingerprint.
+    bool hashypsfp() const { return m_hashypsfp; }
+    // Fingerprint of all essential hypotheses combined
+    Fingerprint const & hypsfp() const { return m_hypsfp; }
+    // Fingerprint of a generated term. Return NULL if not okay.
+    Fingerprint const * termfp(Typenum type, Terms::size_type index) const
+    {
+        if (m_termfps.size() <= type)
+            m_termfps.resize(type + 1);
+        std::vector<std::pair<bool, Fingerprint> > & fps = m_termfps[type];
+        Terms const & terms = genresult[type];
+        Fingerprints const & vars = ctxvarfps();
+        // Evaluate each term once.
+        while (fps.size() <= index)
+        {
+            fps.push_back(std::pair<bool, Fingerprint>());
+            fps.back().first = propctors.fingerprint
+            (terms[fps.size() - 1], vars, m_fpstack, fps.back().second);
+        }
+        return fps[index].first ? &fps[index].second : NULL;
+    }
 private:
     // Add moves with free variables.
     // Return true if it has no open hypotheses.
@@ -123,6 +249,28 @@ private:
     HypsCNF const allhypsCNF;
     Atom hypnatoms;
     double const weightfactor;
+    // BDDs owned by the context, if not given one
+    BDDs m_ownbdds;
+    // BDDs shared with the contexts made from this one
+    BDDs & m_bdds;
+    // BDDs of the hypotheses, top for floating ones
+    BDDs::Refs m_hypBDDs;
+    // BDD of all essential hypotheses combined
+    BDDs::Ref m_hypsBDD;
+    bool m_hashypsBDD;
+    // Scratch stack for BDD evaluation
+    BDDs::Refs mutable m_bddstack;
+    // Max id of variables in the context
+    Symbol2::ID m_maxvarid;
+    // Fingerprint of all essential hypotheses combined
+    Fingerprint m_hypsfp;
+    bool m_hashypsfp;
+    // Fingerprints of variables by id
+    Fingerprints mutable m_varfps;
+    // m_termfps[type][i] = (okay, fingerprint of generated term i)
+    std::vector<std::vector<std::pair<bool, Fingerprint> > > mutable m_termfps;
+    // Scratch stack for fingerprint evaluation
+    Fingerprints mutable m_fpstack;
 };
 
 #endif // PROP_H_INCLUDED
@@ -1,5 +1,10 @@
-#include "../io.h"
+#include "gen.h"
 #include "problem.h"
+#include "../database.h"
+#include "../io.h"
+#include "../propctor.h"
+#include "../util/for.h"
+#include "../util/timer.h"
 
 // Test proof search. Return tree.size if okay. Return 0 if not.
 Treesize testsearch(Assiter iter, Problem & tree, Treesize maxsize)
@@ -26,3 +31,40 @@ Treesize testsearch(Assiter iter, Problem & tree, Treesize maxsize)
         tree.writeproof((std::string(iter->first) + ".txt").c_str());
     return tree.size();
 }
+
+// Benchmark term generation by enumerating all terms of a type
+// built from propositional syntax axioms and the first few variables
+// up to a given size. Return true if okay.
+bool testgen
+    (Database const & database, strview type,
+     Varusage::size_type nvars, RPNsize maxsize)
+{
+    std::cout << "Generating " << type << " terms up to size " << maxsize;
+    // The first nvars variables of the type
+    Varusage varusage;
+    Hypotheses const & hyps = database.hypotheses();
+    for (Hypiter iter = hyps.begin();
+         iter != hyps.end() && varusage.size() < nvars; ++iter)
+    {
+        Expression const & exp = iter->second.expression;
+        if (iter->second.floats && exp.size() == 2 && exp[0] == type)
+            varusage[Symbol3(exp[1], database.varid(exp[1]), iter)];
+    }
+    if (unexpected(varusage.empty(), "no variable of type", type))
+        return false;
+
+    Gen gen(varusage, -1);
+    Propctors const & propctors = GETINFO(database, Propctors);
+    FOR (Syntaxioms::const_reference syntaxiom, database.syntaxioms())
+        if (propctors.count(syntaxiom.first))
+            gen.syntaxioms.insert(syntaxiom);
+
+    Timer timer;
+    Typenum const typenum = gen.typenum(type);
+    gen.generateupto(typenum, maxsize);
+    Time const time = timer;
+    Terms::size_type const count = gen.genresult[typenum].size();
+    std::cout << ": " << count << " terms in " << time << "s = ";
+    std::cout << count/time << " tps" << std::endl;
+    return count > 0;
+}
@@ -79,25 +79,34 @@ static Section & addsection(Sections & sections, Sectionlevel const level)
     return sections[number];
 }
 
-// Parse section header. Returns true iff there is a header ($4.4.1/Headings).
-static bool parseheader(Comment const & comment, Sections & sections)
+// Parse section header into its level and title.
+// Returns true iff there is a header ($4.4.1/Headings).
+static bool parseheader
+    (std::string const & text, Sectionlevel & level, std::string & title)
 {
-    std::string const & text(comment.text);
     // The first char should be \n.
     if (text.empty() || text[0] != '\n')
         return false;
     // Get marker.
     std::string::size_type end(text.find('\n', 1));
     std::string const mark(text.substr(1, end - 1));
-    Sectionlevel const level(sectionlevel(mark));
+    level = sectionlevel(mark);
     if (level == 0 || end >= text.size())
         return false;
     // Get title.
     std::string::size_type const begin(end + 1);
     end = text.find('\n', begin);
-    std::string title(trim(text.substr(begin, end - begin)));
+    title = trim(text.substr(begin, end - begin));
     // Check markers match.
-    if (text.compare(end + 1, mark.size(), mark) != 0)
+    return text.compare(end + 1, mark.size(), mark) == 0;
+}
+
+// Parse section header. Returns true iff there is a header ($4.4.1/Headings).
+static bool parseheader(Comment const & comment, Sections & sections)
+{
+    Sectionlevel level;
+    std::string title;
+    if (!parseheader(comment.text, level, title))
         return false;
     // Add new section.
     Section & section(addsection(sections, level));
@@ -106,6 +115,17 @@ static bool parseheader(Comment const & comment, Sections & sections)
     return true;
 }
 
+// Return true if a comment is a section header whose title begins with str.
+bool isheader(strview text, const char * str)
+{
+    // Most comments are not headers.
+    if (text.c_str[0] != '\n')
+        return false;
+    Sectionlevel level;
+    std::string title;
+    return parseheader(text, level, title) && strview(title).remove_prefix(str);
+}
+
 // Parse section header ($4.4.1/Headings).
 Sections::Sections(struct Comments const & comments)
 {
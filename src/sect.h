@@ -34,6 +34,9 @@ struct Sections : std::map<Sectionnumber, Section>
     Sections(struct Comments const & comments);
 };
 
+// Return true if a comment is a section header whose title begins with str.
+bool isheader(struct strview text, const char * str);
+
 std::ostream & operator<<(std::ostream & out, const Sectionnumber & sn);
 std::ostream & operator<<(std::ostream & out, const Section & sect);
 
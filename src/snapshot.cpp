@@ -0,0 +1,181 @@
+#include <algorithm>    // for std::equal
+#include <fstream>
+#include <iostream>
+#include <map>
+#include "database.h"
+#include "io.h"
+#include "proof/analyze.h"
+#include "snapshot.h"
+#include "util/for.h"
+
+// Hash identifying the source read into the first n tokens:
+// the text read from the file and the included files, and the format.
+std::size_t hashsource(Tokens const & tokens, Tokens::size_type n)
+{
+    util::Hash hash(tokens.hash);
+    return hash.add(n).add(Snapshot::VERSION).value();
+}
+
+// Encode a RPN, with pointers to hypotheses as indices.
+static std::vector<unsigned> encode
+    (RPN const & rpn, std::map<pHyp, unsigned> const & hypindices)
+{
+    std::vector<unsigned> result(rpn.size());
+    for (RPNsize i = 0; i < rpn.size(); ++i)
+        result[i] = rpn[i].isthm() ? rpn[i].pass->second.number << 1 | 1 :
+            hypindices.find(rpn[i].phyp)->second << 1;
+    return result;
+}
+
+// Take a snapshot of a processed database.
+Snapshot::Snapshot(Database const & database, std::size_t hash) : hash(hash)
+{
+    Assiters const & assiters = database.assiters();
+    Hypotheses const & hypotheses = database.hypotheses();
+
+    std::map<pHyp, unsigned> hypindices;
+    FOR (Hypotheses::const_reference hyp, hypotheses)
+        hypindices.insert(std::make_pair(&hyp, hypindices.size()));
+
+    rpns.reserve(assiters.size() - 1 + hypotheses.size());
+    for (nAss i = 1; i < assiters.size(); ++i)
+        rpns.push_back(encode(assiters[i]->second.expRPN, hypindices));
+    FOR (Hypotheses::const_reference hyp, hypotheses)
+        rpns.push_back(encode(hyp.second.rpn, hypindices));
+}
+
+// Header of a snapshot file
+struct Snapshotheader
+{
+    char magic[4];
+    unsigned version;
+    unsigned sizeofhash;
+    std::size_t hash;
+    std::size_t nrpns;
+    // Return true if the header matches the current format.
+    bool good() const
+    {
+        return std::equal(magic, magic + 4, "hana") && version == Snapshot::VERSION
+            && sizeofhash == sizeof(std::size_t);
+    }
+};
+
+// Read a snapshot of the source with a given hash. Return true if okay.
+bool Snapshot::read(const char * filename, std::size_t hash)
+{
+    std::ifstream in(filename, std::ios::binary);
+    if (!in.good())
+        return false;
+
+    Snapshotheader header;
+    in.read(reinterpret_cast<char *>(&header), sizeof(header));
+    if (!in.good() || !header.good() || header.hash != hash)
+        return false;
+
+    std::vector<std::vector<unsigned> > newrpns(header.nrpns);
+    FOR (std::vector<unsigned> & rpn, newrpns)
+    {
+        unsigned size = 0;
+        in.read(reinterpret_cast<char *>(&size), sizeof(size));
+        if (!in.good())
+            return false;
+        rpn.resize(size);
+        if (size > 0)
+            in.read(reinterpret_cast<char *>(&rpn[0]), size * sizeof(unsigned));
+        if (!in.good())
+            return false;
+    }
+
+    this->hash = hash;
+    rpns.swap(newrpns);
+    return true;
+}
+
+// Save the snapshot. Return true if okay.
+bool Snapshot::save(const char * filename) const
+{
+    std::ofstream out(filename, std::ios::binary);
+    if (!out.good())
+        return !unexpected(true, "file open error", filename);
+
+    Snapshotheader const header =
+        {{'h', 'a', 'n', 'a'}, VERSION, sizeof(std::size_t), hash, rpns.size()};
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    FOR (std::vector<unsigned> const & rpn, rpns)
+    {
+        unsigned const size = rpn.size();
+        out.write(reinterpret_cast<const char *>(&size), sizeof(size));
+        if (size > 0)
+            out.write(reinterpret_cast<const char *>(&rpn[0]),
+                      size * sizeof(unsigned));
+    }
+
+    return out.good() || !unexpected(true, "file write error", filename);
+}
+
+// Decode a RPN. Return true if okay.
+static bool decode(std::vector<unsigned> const & codes, RPN & rpn,
+                   Assiters const & assiters, std::vector<pHyp> const & hyps)
+{
+    rpn.resize(codes.size());
+    for (RPNsize i = 0; i < codes.size(); ++i)
+    {
+        unsigned const index = codes[i] >> 1;
+        if (codes[i] & 1)
+        {
+            if (index == 0 || index >= assiters.size())
+                return false;
+            rpn[i] = &*assiters[index];
+        }
+        else
+        {
+            if (index >= hyps.size())
+                return false;
+            rpn[i] = hyps[index];
+        }
+    }
+    return true;
+}
+
+// Add the revPolish notation saved in a snapshot. Return true if okay.
+bool Database::addRPN(Snapshot const & snapshot)
+{
+    m_syntaxioms = Syntaxioms(assertions(), *this);
+
+    if (unexpected(snapshot.rpns.size() !=
+                   assiters().size() - 1 + hypotheses().size(),
+                   "snapshot size", snapshot.rpns.size()))
+        return false;
+
+    std::vector<pHyp> hyps;
+    hyps.reserve(hypotheses().size());
+    FOR (Hypotheses::const_reference hyp, hypotheses())
+        hyps.push_back(&hyp);
+
+    for (nAss i = 1; i < assiters().size(); ++i)
+    {
+        Assertion & ass = const_cast<Assertion &>(assiters()[i]->second);
+        if (!decode(snapshot.rpns[i - 1], ass.expRPN, assiters(), hyps))
+            return !unexpected(true, "snapshot RPN of", assiters()[i]->first);
+        ass.expAST = ast(ass.expRPN);
+        if (unexpected(ass.expAST.empty(), "AST error", ass.expRPN))
+            return false;
+        ass.expmaxabs = maxabs(ass.expRPNAST());
+    }
+
+    std::vector<std::vector<unsigned> >::const_iterator
+        iter = snapshot.rpns.begin() + assiters().size() - 1;
+    FOR (Hypotheses::reference hyp, m_hypotheses)
+    {
+        if (!decode(*iter++, hyp.second.rpn, assiters(), hyps))
+            return !unexpected(true, "snapshot RPN of", hyp.first);
+        if (hyp.second.rpn.empty())
+            continue; // Hypothesis never parsed
+        hyp.second.ast = ast(hyp.second.rpn);
+        if (unexpected(hyp.second.ast.empty(), "AST error", hyp.second.rpn))
+            return false;
+    }
+
+    addrelations();
+    return true;
+}
@@ -0,0 +1,36 @@
+#ifndef SNAPSHOT_H_INCLUDED
+#define SNAPSHOT_H_INCLUDED
+
+#include <cstddef>  // for std::size_t
+#include <vector>
+#include "token.h"
+
+// Hash identifying the source read into the first n tokens:
+// the text read from the file and the included files, and the format.
+std::size_t hashsource(Tokens const & tokens, Tokens::size_type n);
+
+// Binary snapshot of the results of processing a database.
+// Only the RPNs of assertions and hypotheses are saved, with pointers
+// as indices. The rest of the database is rebuilt from the source and
+// the RPNs. A snapshot records that, on the same source, the proofs were
+// verified and the RPNs and propositional assertions were checked.
+struct Snapshot
+{
+    // Bump when the format changes.
+    static const unsigned VERSION = 2;
+    // Hash of the source
+    std::size_t hash;
+    // RPNs of the conclusions of assertions, by number from 1,
+    // followed by RPNs of hypotheses, in label order.
+    // Each step is saved as (index << 1 | is theorem).
+    std::vector<std::vector<unsigned> > rpns;
+    Snapshot() : hash(0) {}
+    // Take a snapshot of a processed database.
+    Snapshot(class Database const & database, std::size_t hash);
+    // Read a snapshot of the source with a given hash. Return true if okay.
+    bool read(const char * filename, std::size_t hash);
+    // Save the snapshot. Return true if okay.
+    bool save(const char * filename) const;
+};
+
+#endif // SNAPSHOT_H_INCLUDED
@@ -21,18 +21,17 @@ nAss maxsymboldefnumber
 //std::cout << definitions << syntaxioms;
     FOR (RPNstep const step, exp)
         if (step.isthm() && step.pass)
-            if (const char * const label = step.pass->first.c_str)
     {
         nAss number = 0;
-        typename T::const_iterator iterdf = definitions.find(label);
+        typename T::const_pointer iterdf = definitions.findass(step.pass);
 //std::cout << "sa";
-        if (iterdf != definitions.end())
+        if (iterdf)
             number = iterdf->second.pdef ? iterdf->second : n;
         else
         {
 //std::cout << "ud";
-            Syntaxioms::const_iterator itersyn=syntaxioms.find(strview(step));
-            if (itersyn != syntaxioms.end())
+            Syntaxioms::const_pointer itersyn = syntaxioms.findass(step.pass);
+            if (itersyn)
                 number = itersyn->second; // found in syntax axioms
             else
                 return 0; // undefined symbol
@@ -2,34 +2,63 @@
 #define SYNTAXDAG_H_INCLUDED
 
 #include <algorithm>    // for std::min and std::max
+#include <limits>       // for digits
 #include <map>
-#include <set>
-#include "util/DAG.h"
+#include <string>
+#include <vector>
+#include "util/bits.h"
 #include "util/for.h"
 #include "types.h"
 
 // DAG built from syntax axioms.
 // x -> y if definition of x ultimatedly uses y.
+// Ranks are numbered densely, with reachability as a bit-matrix.
 struct SyntaxDAG
 {
-    // Classes of syntax axioms
-    typedef std::set<std::string> Ranks;
-    typedef Ranks::const_iterator Rankiter;
+    // Dense ID of a class of syntax axioms
+    typedef std::size_t Rank;
+    // Set of ranks, as a bitmask by ID
+    typedef std::vector<std::size_t> Ranks;
     // Map: syntaxiom -> rank
-    typedef std::map<strview, strview> Syntaxranks;
+    typedef std::map<strview, Rank> Syntaxranks;
     typedef Syntaxranks::const_iterator Mapiter;
-    // DAG over map: rank -> min # of syntaxiom of that rank
-    typedef DAG<std::map<std::string, std::size_t> > RanksDAG;
-    typedef RanksDAG::const_iterator RankDAGiter;
-    RanksDAG const & ranksDAG() const { return m_ranksDAG; }
+    // # ranks
+    Rank nranks() const { return m_names.size(); }
+    // Name of a rank
+    std::string const & rankname(Rank rank) const { return m_names[rank]; }
+    // Min # of syntaxiom of a rank
+    std::size_t ranknumber(Rank rank) const { return m_numbers[rank]; }
+    // Return true if a rank is in a set. Missing words are 0.
+    static bool has(Ranks const & ranks, Rank rank)
+    {
+        return rank / std::numeric_limits<std::size_t>::digits < ranks.size()
+            && util::testbit(ranks, rank);
+    }
+    // Names of ranks in a set
+    std::vector<std::string> ranknames(Ranks const & ranks) const
+    {
+        std::vector<std::string> result;
+        for (Rank rank = 0; rank < nranks(); ++rank)
+            if (has(ranks, rank))
+                result.push_back(rankname(rank));
+        return result;
+    }
     // Add a syntaxiom and put it in a rank.
     void addsyntax(strview syntaxiom, std::size_t number, strview rank)
     {
-        std::pair<RanksDAG::iterator, bool> const result
-        = m_ranksDAG.insert(std::make_pair(rank, number));
-        if (!result.second) // Another syntaxiom of same rank found
-            result.first->second = std::min(number, result.first->second);
-        syntaxranks[syntaxiom] = result.first->first;
+        std::pair<std::map<std::string, Rank>::iterator, bool> const result
+        = m_rankids.insert(std::make_pair(std::string(rank), nranks()));
+        Rank const id = result.first->second;
+        if (result.second)
+        {
+            // New rank
+            m_names.push_back(result.first->first);
+            m_numbers.push_back(number);
+            m_reaches.resize(nranks()), m_reachers.resize(nranks());
+        }
+        else // Another syntaxiom of same rank found
+            m_numbers[id] = std::min(number, m_numbers[id]);
+        syntaxranks[syntaxiom] = id;
     }
     // Add the definition of salabel to the DAG of syntax axioms.
     void adddef(strview salabel, RPN const & def)
@@ -44,105 +73,145 @@ struct SyntaxDAG
     // Add ranks to the set of maximal ranks.
     void addranks(Ranks & maxranks, Ranks const & newranks) const
     {
-        FOR (strview exprank, newranks)
+        maxranks.resize(util::nwords<std::size_t>(nranks()));
+        for (Rank rank = 0; rank < nranks(); ++rank)
         {
-            if (!ismaximal(exprank, maxranks))
+            if (!has(newranks, rank) || !ismaximal(rank, maxranks))
                 continue;
-            // exprank is maximal.
-            Rankiter const newiter = maxranks.insert(exprank).first;
-            // Remove non-maximal ranks.
-            for (Rankiter iter = maxranks.begin();
-                iter != maxranks.end(); )
-                if (iter == newiter || ismaximal(*iter, maxranks))
-                    ++iter;
-                else
-                    maxranks.erase(iter++);
+            // rank is maximal. Remove ranks it reaches, which are not.
+            andnot(maxranks, m_reaches[rank]);
+            util::setbit(maxranks, rank);
         }
     }
     // Return the ranks of a rev-Polish notation.
     Ranks RPNranks(RPN const & exp) const
     {
-        Ranks result;
+        Ranks result(util::nwords<std::size_t>(nranks()));
         FOR (RPNstep const step, exp)
             if (step.isthm())
             {
                 Mapiter const iter = syntaxranks.find(step.pass->first);
                 if (iter != syntaxranks.end())
-                    result.insert(iter->second);
+                    util::setbit(result, iter->second);
             }
         return result;
     }
     // Return true if there is no x in ranks such that rank < x.
-    bool ismaximal(strview rank, Ranks const & ranks) const
-    {
-        // Locate the rank.
-        RankDAGiter const to = ranksDAG().find(rank);
-        if (to == ranksDAG().end())
-            return true; // Rank unseen.
-        // Rank seen.
-        FOR (strview fromrank, ranks)
-        {
-            RankDAGiter const from = ranksDAG().find(fromrank);
-            if (from != ranksDAG().end() && ranksDAG().reachable(from, to))
-                return false;
-        }
-        return true;
-    }
+    bool ismaximal(Rank rank, Ranks const & ranks) const
+    { return !intersect(ranks, m_reachers[rank]); }
     // max # rank in a rank set
     std::size_t maxranknumber(Ranks const & ranks) const
     {
         std::size_t max = 0;
-        FOR (strview rank, ranks)
-            max = std::max(max, ranksDAG().at(rank));
+        for (Rank rank = 0; rank < nranks(); ++rank)
+            if (has(ranks, rank))
+                max = std::max(max, ranknumber(rank));
         return max;
     }
-    // Find the rank of a syntaxiom.
-    // Return ranksDAG().end() if not found.
-    RankDAGiter rankDAGiter(strview label) const
-    {
-        Mapiter const mapiter = syntaxranks.find(label);
-        if (mapiter == syntaxranks.end())
-            return ranksDAG().end();
-        return ranksDAG().find(mapiter->second);
-    }
-    // Add an edge between syntax axioms. Returns true if edge is added.
+    // Add an edge between syntax axioms.
+    // Return true if reachability is extended.
     bool link(strview from, strview to)
     {
-        RankDAGiter fromiter = rankDAGiter(from);
-        if (fromiter == m_ranksDAG.end())
+        Mapiter const fromiter = syntaxranks.find(from);
+        if (fromiter == syntaxranks.end())
             return false; // Rank unseen
-        RankDAGiter toiter   = rankDAGiter(to);
-        if (toiter == m_ranksDAG.end())
+        Mapiter const toiter = syntaxranks.find(to);
+        if (toiter == syntaxranks.end())
             return false; // Rank unseen
-        return m_ranksDAG.link(fromiter, toiter);
+        return link(fromiter->second, toiter->second);
     }
+    // Return true if a rank reaches the other.
+    bool reachable(Rank from, Rank to) const
+    { return has(m_reaches[from], to); }
     // Return true if a node reaches the other.
     bool reachable(strview from, strview to) const
     {
-        RankDAGiter fromiter = rankDAGiter(from);
-        if (fromiter == m_ranksDAG.end())
+        Mapiter const fromiter = syntaxranks.find(from);
+        if (fromiter == syntaxranks.end())
             return false; // Rank unseen
-        RankDAGiter toiter   = rankDAGiter(to);
-        if (toiter == m_ranksDAG.end())
+        Mapiter const toiter = syntaxranks.find(to);
+        if (toiter == syntaxranks.end())
             return false; // Rank unseen
-        return ranksDAG().reachable(fromiter, toiter);
+        return reachable(fromiter->second, toiter->second);
     }
     // Ranks A < B if B is non-empty and
     // for all a in A, there is b in B such that a < b.
     bool simplerthan(Ranks const & A, Ranks const & B) const
     {
-        if (B.empty())
+        if (isempty(B))
             return false;
-        FOR (strview a, A)
-            if (ismaximal(a, B))
+        for (Rank a = 0; a < nranks(); ++a)
+            if (has(A, a) && ismaximal(a, B))
                 return false;
         return true;
     }
 private:
-    // DAG of classes of syntax axioms
-    RanksDAG m_ranksDAG;
+    // Map: name of rank -> its ID
+    std::map<std::string, Rank> m_rankids;
+    // m_names[rank] = name of the rank
+    std::vector<std::string> m_names;
+    // m_numbers[rank] = min # of syntaxiom of the rank
+    std::vector<std::size_t> m_numbers;
+    // m_reaches[rank] = ranks reachable from the rank
+    std::vector<Ranks> m_reaches;
+    // m_reachers[rank] = ranks reaching the rank
+    std::vector<Ranks> m_reachers;
     // Map: syntaxiom -> rank
     Syntaxranks syntaxranks;
+    // Return true if a set is empty.
+    static bool isempty(Ranks const & ranks)
+    {
+        FOR (std::size_t word, ranks)
+            if (word)
+                return false;
+        return true;
+    }
+    // Return true if two sets intersect.
+    static bool intersect(Ranks const & x, Ranks const & y)
+    {
+        for (Ranks::size_type i = 0; i < x.size() && i < y.size(); ++i)
+            if (x[i] & y[i])
+                return true;
+        return false;
+    }
+    // x -= y
+    static void andnot(Ranks & x, Ranks const & y)
+    {
+        for (Ranks::size_type i = 0; i < x.size() && i < y.size(); ++i)
+            x[i] &= ~y[i];
+    }
+    // x |= y
+    static void orwith(Ranks & x, Ranks const & y)
+    {
+        if (x.size() < y.size())
+            x.resize(y.size());
+        for (Ranks::size_type i = 0; i < y.size(); ++i)
+            x[i] |= y[i];
+    }
+    // Add an edge between ranks. Return true if reachability is extended.
+    bool link(Rank from, Rank to)
+    {
+        if (from == to || reachable(to, from))
+            return false; // Self loop or cycle not allowed
+        if (reachable(from, to))
+            return false; // Already reachable
+        std::size_t const n = util::nwords<std::size_t>(nranks());
+        // Ranks reaching from, with from
+        Ranks src(m_reachers[from]);
+        src.resize(n), util::setbit(src, from);
+        // Ranks reached by to, with to
+        Ranks dst(m_reaches[to]);
+        dst.resize(n), util::setbit(dst, to);
+        // Each rank in src now reaches each rank in dst.
+        for (Rank rank = 0; rank < nranks(); ++rank)
+        {
+            if (util::testbit(src, rank))
+                orwith(m_reaches[rank], dst);
+            if (util::testbit(dst, rank))
+                orwith(m_reachers[rank], src);
+        }
+        return true;
+    }
 };
 
 #endif
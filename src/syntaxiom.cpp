@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <sstream>
 #include "database.h"
 #include "disjvars.h"
 #include "io.h"
@@ -7,9 +8,11 @@
 #include "proof/verify.h"
 #include "syntaxiom.h"
 #include "typecode.h"
+#include "util/bits.h"
 #include "util/for.h"
 #include "util/iter.h"
 #include "util/progress.h"
+#include "util/thread.h"
 
 // Filter assertions for syntax axioms, i.e.,
 // those starting with a primitive type code and having no essential hypothesis
@@ -38,33 +41,41 @@ Syntaxioms::Syntaxioms
         }
     }
 //std::cout << std::endl;
+    // Number the constants.
     FOR (const_reference axiom, *this)
-        m_map.addkeys(axiom.second.constants, &axiom);
+        FOR (strview constant, axiom.second.constants)
+            m_constids.add(constant);
+    // Fill the masks.
+    FOR (reference axiom, *this)
+    {
+        Constmask & mask = axiom.second.mask;
+        mask.assign(util::nwords<Constmask::value_type>(m_constids.size()), 0);
+        FOR (strview constant, axiom.second.constants)
+            util::setbit(mask, m_constids.id(constant));
+    }
+    index(assertions);
 }
 
-Syntaxioms::Syntaxioms
-    (Constants const & expconstants, std::vector<const_pointer> const & v)
+// Return the syntax axioms whose constants are all in exp, in label order.
+Syntaxiomptrs Syntaxioms::filterbyexp(Expression const & exp) const
 {
-    FOR (const_pointer p, v)
+    // Mask of constants in exp
+    Constmask mask(util::nwords<Constmask::value_type>(m_constids.size()));
+    for (Expiter iter = exp.begin() + 1; iter != exp.end(); ++iter)
     {
-//std::cout << p->first << ' ';
-        Constants const & constants = p->second.constants;
-        // If the constants in the syntax axiom are all found in exp,
-        if (std::includes(expconstants.begin(), expconstants.end(),
-                          constants.begin(), constants.end()))
-            // add it to the set of filtered syntax axioms.
-            // std::cout << "\\/ ",
-            insert(*p);
+        if (iter->id)
+            continue; // Variable
+        if (util::Interner::ID const constid = m_constids.id(*iter))
+            util::setbit(mask, constid);
     }
-}
 
-// Filter syntax axioms whose constants are all in exp.
-Syntaxioms Syntaxioms::filterbyexp(Expression const & exp) const
-{
-    Constants constants; // Constants in exp
-    std::remove_copy_if(exp.begin() + 1, exp.end(),
-                        end_inserter(constants), id);
-    return Syntaxioms(constants, m_map.keyin(constants));
+    // A word-wise subset test per axiom is cheap next to parsing,
+    // so the axioms are not indexed by constant.
+    Syntaxiomptrs result;
+    FOR (const_reference axiom, *this)
+        if (util::issubset(axiom.second.mask, mask))
+            result.push_back(&axiom);
+    return result;
 }
 
 // Return the revPolish notation of exp. Return the empty proof iff not okay.
@@ -72,8 +83,8 @@ RPN Syntaxioms::parse(Expression const & exp, Assertion const & ass) const
 {
     if (exp.empty()) return RPN();
 
-    Syntaxioms const & filtered(filterbyexp(exp));
-    Subexprecords recs;
+    Syntaxiomptrs const & filtered(filterbyexp(exp));
+    Subexprecords recs(exp.size());
     Substframe::Subexpends const & ends
         (RPNmap(exp[0], exp.begin() + 1, exp.end(), exp, ass, filtered, recs));
 
@@ -94,8 +105,8 @@ bool Syntaxioms::RPNAST
     return !unexpected(tree.empty(), "AST error", rpn);
 }
 
-// Add the revPolish notation of the whole assertion. Return true if okay.
-bool Syntaxioms::addRPN
+// Add the revPolish notation of the conclusion. Return true if okay.
+bool Syntaxioms::addexpRPN
     (Assertion & ass, struct Typecodes const & typecodes) const
 {
     Expression exp(ass.expression);
@@ -106,54 +117,132 @@ bool Syntaxioms::addRPN
     if (!RPNAST(exp, ass, ass.expRPN, ass.expAST))
         return false;
     ass.expmaxabs = maxabs(ass.expRPNAST());
+    return true;
+}
+
+// Add the revPolish notation of a hypothesis. Return true if okay.
+bool Syntaxioms::addhypRPN
+    (Assertion const & ass, Hypsize i, struct Typecodes const & typecodes) const
+{
+    if (ass.hypexp(i).empty())
+        return false;
+
+    Hypothesis & hyp = const_cast<Hypothesis &>(ass.hyp(i));
+    if (ass.hypfloats(i))
+    {
+        // Floating hypothesis
+        hyp.rpn.assign(1, ass.hypptr(i));
+        hyp.ast.assign(1, ASTnode());
+        return true;
+    }
+    // Essential hypothesis
+    Expression exp(ass.hypexp(i));
+    exp[0] = typecodes.normalize(exp[0]);
+    return RPNAST(exp, ass, hyp.rpn, hyp.ast);
+}
+
+// Return true if a hypothesis has been parsed.
+static bool parsed(Hypothesis const & hyp)
+{
+    return !hyp.rpn.empty() && hyp.ast.size() == hyp.rpn.size();
+}
+
+// Add the revPolish notation of the whole assertion. Return true if okay.
+bool Syntaxioms::addRPN
+    (Assertion & ass, struct Typecodes const & typecodes) const
+{
+    if (!addexpRPN(ass, typecodes))
+        return false;
     // Parse the hypotheses.
     for (Hypsize i = 0; i < ass.nhyps(); ++i)
     {
         if (ass.hypexp(i).empty())
             return false;
-
-        Hypothesis & hyp = const_cast<Hypothesis &>(ass.hyp(i));
-        if (!hyp.rpn.empty() && hyp.ast.size() == hyp.rpn.size())
+        if (parsed(ass.hyp(i)))
             continue; // Hypothesis already parsed
-        // Parse the hypothesis.
-        if (ass.hypfloats(i))
-        {
-            // Floating hypothesis
-            hyp.rpn.assign(1, ass.hypptr(i));
-            hyp.ast.assign(1, ASTnode());
-        }
-        else
-        {
-            // Essential hypothesis
-            exp = ass.hypexp(i);
-            exp[0] = typecodes.normalize(exp[0]);
-            if (!RPNAST(exp, ass, hyp.rpn, hyp.ast))
-                return false;
-        }
+        if (!addhypRPN(ass, i, typecodes))
+            return false;
     }
 
     return true;
 }
 
+// Parsing of the conclusion or a hypothesis of an assertion
+struct RPNjob
+{
+    Assertions::pointer pass;
+    // Index of the hypothesis, or NOHYP for the conclusion
+    Hypsize hyp;
+    static const Hypsize NOHYP = static_cast<Hypsize>(-1);
+    RPNjob(Assertions::pointer p, Hypsize i = NOHYP) : pass(p), hyp(i) {}
+};
+
+// Parser of conclusions and hypotheses, run in parallel
+struct RPNadder
+{
+    Syntaxioms const & syntaxioms;
+    Typecodes const & typecodes;
+    std::vector<RPNjob> const & jobs;
+    // okay[i] = job i is okay
+    std::vector<char> & okay;
+    // errors[i] = error messages of job i
+    std::vector<std::string> & errors;
+    RPNadder(Syntaxioms const & syntaxioms, Typecodes const & typecodes,
+             std::vector<RPNjob> const & jobs, std::vector<char> & okay,
+             std::vector<std::string> & errors) :
+        syntaxioms(syntaxioms), typecodes(typecodes), jobs(jobs), okay(okay),
+        errors(errors) {}
+    // Do job i.
+    void operator()(std::size_t i) const
+    {
+        Assertion & ass = jobs[i].pass->second;
+        Hypsize const hyp = jobs[i].hyp;
+        // Collect the error messages, to be printed after joining.
+        std::ostringstream out;
+        Errorsto const errorsto(out);
+        if (!(okay[i] = hyp == RPNjob::NOHYP ?
+              syntaxioms.addexpRPN(ass, typecodes) :
+              syntaxioms.addhypRPN(ass, hyp, typecodes)))
+            errors[i] = out.str();
+    }
+};
+
 // Add the revPolish notation of a set of assertions. Return true if okay.
+// Each hypothesis is parsed once, with the first assertion using it.
 bool Syntaxioms::addRPN
     (Assertions & assertions, struct Typecodes const & typecodes) const
 {
     Progress progress;
 
-    nAss nass = 0, all = assertions.size();
+    // Jobs in the order of a serial parse
+    std::vector<RPNjob> jobs;
+    std::set<pHyp> hyps;
     FOR (Assertions::reference rass, assertions)
     {
-        if (!addRPN(rass.second, typecodes))
-        {
-            printass(rass);
-            std::cerr << "\nRPN error!" << std::endl;
-            return false;
-        }
-        progress << ++nass/static_cast<Ratio>(all);
+        Assertion const & ass = rass.second;
+        jobs.push_back(RPNjob(&rass));
+        for (Hypsize i = 0; i < ass.nhyps(); ++i)
+            if (ass.hypexp(i).empty() ||
+                (!parsed(ass.hyp(i)) && hyps.insert(ass.hypptr(i)).second))
+                jobs.push_back(RPNjob(&rass, i));
     }
 
-    return true;
+    std::vector<char> okay(jobs.size(), true);
+    std::vector<std::string> errors(jobs.size());
+    RPNadder adder(*this, typecodes, jobs, okay, errors);
+    util::parallel_for(jobs.size(), adder);
+    progress << 1;
+
+    std::vector<char>::const_iterator const iter
+        = std::find(okay.begin(), okay.end(), false);
+    if (iter == okay.end())
+        return true;
+    // Report the first bad job.
+    std::vector<RPNjob>::size_type const i = iter - okay.begin();
+    std::cerr << errors[i];
+    printass(*jobs[i].pass);
+    std::cerr << "\nRPN error!" << std::endl;
+    return false;
 }
 
 // Determine if proof is the revPolish notation for the expression of ass.
@@ -194,22 +283,57 @@ bool Syntaxioms::checkRPN
     return true;
 }
 
+// Checker of the syntax of assertions, run in parallel
+struct RPNchecker
+{
+    Syntaxioms const & syntaxioms;
+    Typecodes const & typecodes;
+    std::vector<Assiter> const & iters;
+    // okay[i] = assertion i is okay
+    std::vector<char> & okay;
+    // errors[i] = error messages of assertion i
+    std::vector<std::string> & errors;
+    RPNchecker(Syntaxioms const & syntaxioms, Typecodes const & typecodes,
+               std::vector<Assiter> const & iters, std::vector<char> & okay,
+               std::vector<std::string> & errors) :
+        syntaxioms(syntaxioms), typecodes(typecodes), iters(iters), okay(okay),
+        errors(errors) {}
+    // Check assertion i.
+    void operator()(std::size_t i) const
+    {
+        // Collect the error messages, to be printed after joining.
+        std::ostringstream out;
+        Errorsto const errorsto(out);
+        if (!(okay[i] = syntaxioms.checkRPN(iters[i]->second, typecodes)))
+            errors[i] = out.str();
+    }
+};
+
 // Test syntax parser. Return true if okay.
 bool Database::checkRPN() const
 {
     Progress progress;
 
-    nAss nass = 0, all = assertions().size();
-    FOR (Assertions::const_reference rass, assertions())
-    {
-        if (!syntaxioms().checkRPN(rass.second, typecodes()))
-        {
-            printass(rass);
-            std::cerr << "\nRPN error!" << std::endl;
-            return false;
-        }
-        progress << ++nass/static_cast<Ratio>(all);
-    }
+    // Assertions in the order of a serial check
+    std::vector<Assiter> iters;
+    iters.reserve(assertions().size());
+    for (Assiter iter = assertions().begin(); iter != assertions().end(); ++iter)
+        iters.push_back(iter);
 
-    return true;
+    std::vector<char> okay(iters.size(), true);
+    std::vector<std::string> errors(iters.size());
+    RPNchecker checker(syntaxioms(), typecodes(), iters, okay, errors);
+    util::parallel_for(iters.size(), checker);
+    progress << 1;
+
+    std::vector<char>::const_iterator const iter
+        = std::find(okay.begin(), okay.end(), false);
+    if (iter == okay.end())
+        return true;
+    // Report the first bad assertion.
+    std::vector<Assiter>::size_type const i = iter - okay.begin();
+    std::cerr << errors[i];
+    printass(*iters[i]);
+    std::cerr << "\nRPN error!" << std::endl;
+    return false;
 }
@@ -2,21 +2,25 @@
 #define SYNTAXIOM_H_INCLUDED
 
 #include "ass.h"
-#include "util/incl.h"
+#include "parse.h"  // for Syntaxiomptrs
+#include "util/intern.h"
 
 // Set of constants
 typedef std::set<strview> Constants;
+// Bitmask over the constants in syntax axioms
+typedef std::vector<std::size_t> Constmask;
 
 // A syntax axiom
 struct Syntaxiom
 {
     pAss pass;
     Constants constants;
+    Constmask mask;
     operator nAss() const { return pass->second.number; }
 };
 
 // Map: label -> syntax axioms
-struct Syntaxioms : std::map<strview, Syntaxiom>
+struct Syntaxioms : Assmap<Syntaxiom>
 {
     Syntaxioms() {}
 // Filter assertions for syntax axioms, i.e.,
@@ -24,26 +28,30 @@ struct Syntaxioms : std::map<strview, Syntaxiom>
 // and find their var types.
     Syntaxioms(Assertions const & assertions, class Database const & database);
 private:
-    util::WeakIncl<strview, const_pointer> m_map;
+    // Constants in syntax axioms, with their IDs as bits in the masks
+    util::Interner m_constids;
 public:
-    Syntaxioms filterbyexp(Expression const & exp) const;
+// Return the syntax axioms whose constants are all in exp, in label order.
+    Syntaxiomptrs filterbyexp(Expression const & exp) const;
 // Return the revPolish notation of exp. Return the empty proof iff not okay.
     RPN parse(Expression const & exp, Assertion const & ass) const;
 // Add the revPolish notation and its AST. Return true if okay.
     bool RPNAST
         (Expression const & exp, Assertion const & ass,
          RPN & rpn, AST & tree) const;
+// Add the revPolish notation of the conclusion. Return true if okay.
+    bool addexpRPN(Assertion & ass, struct Typecodes const & typecodes) const;
+// Add the revPolish notation of a hypothesis. Return true if okay.
+    bool addhypRPN(Assertion const & ass, Hypsize i,
+                   struct Typecodes const & typecodes) const;
 // Add the revPolish notation of the whole assertion. Return true if okay.
     bool addRPN(Assertion & ass, struct Typecodes const & typecodes) const;
 // Add the revPolish notation of a set of assertions. Return true if okay.
+// Each hypothesis is parsed once, with the first assertion using it.
     bool addRPN(Assertions & assertions, struct Typecodes const & typecodes) const;
 // Check the syntax of an assertion (& all hypotheses). Return true if okay.
     bool checkRPN
         (Assertion ass, struct Typecodes const & typecodes) const;
-private:
-    friend class Database;
-    Syntaxioms
-        (Constants const & expconstants, std::vector<const_pointer> const & v);
 };
 
 #endif // SYNTAXIOM_H_INCLUDED
@@ -1,11 +1,17 @@
 #include <algorithm>    // for std::find_if, std::count_if
+#include <cstdio>       // for std::remove
+#include <fstream>
+#include <iterator>     // for std::istreambuf_iterator
 #include <vector>
 #include "util/arith.h"
 #include "util/DAG.h"
 #include "util/filter.h"
 #include "util/find.h"
 #include "util/for.h"
+#include "util/thread.h"
+#include "util/timer.h"
 #include "ass.h"
+#include "comment.h"
 #include "io.h"
 #include "MCTS/tree.h"
 
@@ -103,6 +109,133 @@ bool checkassiters
     return true;
 }
 
+// Write text to a file. Return true if okay.
+static bool writefile(const char * name, std::string const & text)
+{
+    std::ofstream out(name, std::ios::binary);
+    if (!(out << text))
+        return !(std::cerr << "Could not write " << name << std::endl);
+    return true;
+}
+
+// Benchmark tokenizing several copies of a file, on 1 thread and on all.
+// The copies are written to readbench.mm in the working directory.
+// Return true if both give the same tokens and comments, copies times
+// as many as the file alone, which should not include other files.
+bool testread(const char * filename, unsigned copies)
+{
+    bool doread(const char * name, Tokens & tokens, Comments & comments,
+                unsigned nthreads, const char * section);
+    std::ifstream in(filename, std::ios::binary);
+    std::string const text((std::istreambuf_iterator<char>(in)),
+                           std::istreambuf_iterator<char>());
+    if (!in)
+        return !(std::cerr << "Could not read " << filename << std::endl);
+    // Counts of tokens and comments in the file alone
+    Tokens::size_type ntokens;
+    Comments::size_type ncomments;
+    {
+        Tokens tokens;
+        Comments comments;
+        if (!doread(filename, tokens, comments, 1, NULL))
+            return false;
+        ntokens = tokens.size();
+        ncomments = comments.size();
+    }
+
+    static const char benchname[] = "readbench.mm";
+    std::string bench;
+    bench.reserve(copies * (text.size() + 1));
+    for (unsigned i = 0; i < copies; ++i)
+        bench += text, bench += '\n';
+    if (!writefile(benchname, bench))
+        return std::remove(benchname), false;
+
+    unsigned const nthreads[] = {1, util::nthreads()};
+    Tokens tokens[2];
+    Comments comments[2];
+    for (unsigned i = 0; i < 2; ++i)
+    {
+        std::cout << "Tokenizing " << copies << " copies of " << filename;
+        std::cout << " on " << nthreads[i] << " thread(s) ";
+        Timer timer;
+        if (!doread(benchname, tokens[i], comments[i], nthreads[i], NULL))
+            return std::remove(benchname), false;
+        std::cout << tokens[i].size() << " tokens in " << timer << 's';
+        std::cout << std::endl;
+    }
+    std::remove(benchname);
+
+    // Check the counts.
+    if (tokens[0].size() != copies * ntokens ||
+        comments[0].size() != copies * ncomments)
+    {
+        std::cerr << "Read " << tokens[0].size() << " tokens and ";
+        std::cerr << comments[0].size() << " comments, expected ";
+        std::cerr << copies * ntokens << " and " << copies * ncomments;
+        return !(std::cerr << std::endl);
+    }
+    // Compare the tokens.
+    if (tokens[0].size() != tokens[1].size())
+        return !(std::cerr << "Token counts differ" << std::endl);
+    for (tokens[0].rewind(), tokens[1].rewind(); !tokens[0].empty();
+         tokens[0].pop(), tokens[1].pop())
+        if (tokens[0].front() != tokens[1].front())
+        {
+            std::cerr << "Token " << tokens[0].position << ": ";
+            std::cerr << tokens[0].front() << " != " << tokens[1].front();
+            return !(std::cerr << std::endl);
+        }
+    // Compare the comments.
+    if (comments[0].size() != comments[1].size())
+        return !(std::cerr << "Comment counts differ" << std::endl);
+    for (Comments::size_type i = 0; i < comments[0].size(); ++i)
+    {
+        Comment const & x = comments[0].at(i), & y = comments[1].at(i);
+        if (x.text != y.text || x.tokenpos != y.tokenpos)
+            return !(std::cerr << "Comment " << i << " differs" << std::endl);
+    }
+
+    return true;
+}
+
+// Read a file up to a section. Return true if the counts of tokens and
+// comments are as expected and the text after the section does not
+// change the hash.
+static bool testreadsection()
+{
+    static const char name[] = "sectiontest.mm";
+    static const char prefix[] = "$( Intro $)\n$c ( ) $.\n"
+        "$(\n####\n  Stop here\n####\n$)\n";
+    bool doread(const char * name, Tokens & tokens, Comments & comments,
+                unsigned nthreads, const char * section);
+    // Two files, differing only after the section header
+    static const char * const suffixes[] =
+        {"$c wff $.\n", "$c |- $.\n$( $)\n"};
+    std::size_t hashes[2];
+    for (unsigned i = 0; i < 2; ++i)
+    {
+        if (!writefile(name, std::string(prefix) + suffixes[i]))
+            return false;
+        Tokens tokens;
+        Comments comments;
+        bool const okay = doread(name, tokens, comments, 1, "Stop");
+        std::remove(name);
+        if (!okay)
+            return false;
+        if (tokens.size() != 4 || comments.size() != 2)
+        {
+            std::cerr << "Read " << tokens.size() << " tokens and ";
+            std::cerr << comments.size() << " comments up to the section";
+            return !(std::cerr << ", expected 4 and 2" << std::endl);
+        }
+        hashes[i] = tokens.hash.value();
+    }
+    if (hashes[0] != hashes[1])
+        return !(std::cerr << "Text after the section changed the hash\n");
+    return true;
+}
+
 bool pretest()
 {
     std::cout << "Testing util" << std::endl;
@@ -112,10 +245,16 @@ bool pretest()
     unsigned testsat2(unsigned n); // should be 0
     std::cout << "Checking SAT: " << testsat1() << std::endl;
     if (testsat2(8) != 0) return false;
+    bool testbdd(unsigned n); // should be 1
+    std::cout << "Checking BDD" << std::endl;
+    if (!testbdd(3)) return false;
     
     std::cout << "Checking DAG" << std::endl;
     if (!testDAG(8)) return false;
 
+    std::cout << "Testing reader" << std::endl;
+    if (!testreadsection()) return false;
+
     std::cout << "Testing tree" << std::endl;
     if (!chain1(8).check()) return false;
 
@@ -5,6 +5,7 @@
 #include "types.h"
 #include "util/for.h"
 // #include "io.h"
+#include "util/intern.h"
 #include "util/simptree.h"
 
 // Node in theorem pool = {RPN, iterators to corresponding assertions}
@@ -178,6 +179,34 @@ struct Theorempool : private SimpTree<Theorempoolnode>
 
 // Map: typecode -> theorems
 typedef std::map<strview, Assiters> Thmpool;
-typedef std::map<strview, Theorempool> Theorempools;
+// Map: typecode -> theorem pool, indexed by the ID of the typecode
+class Theorempools
+{
+    // Type codes, with their IDs as indices into m_pools
+    util::Interner m_typecodes;
+    // m_pools[ID of type code] = its theorem pool
+    std::vector<Theorempool> m_pools;
+public:
+    Theorempools() : m_pools(1) {}
+    // Return the pool of a type code, adding it if new.
+    Theorempool & operator[](strview typecode)
+    {
+        util::Interner::ID const id = m_typecodes.add(typecode);
+        if (id == m_pools.size())
+            m_pools.push_back(Theorempool());
+        return m_pools[id];
+    }
+    // Return the pool of a type code. Return NULL if none.
+    Theorempool const * find(strview typecode) const
+    {
+        util::Interner::ID const id = m_typecodes.id(typecode);
+        return id ? &m_pools[id] : NULL;
+    }
+};
+
+// Assertion and the spans of its conclusion governed by a syntax axiom
+typedef std::pair<pAss, GovernedRPNspans const *> Absentry;
+// Map: syntax axiom -> assertions with spans governed by it, ascending in #
+typedef std::map<RPNstep, std::vector<Absentry> > Absindex;
 
 #endif // THMPOOL_H_INCLUDED
@@ -3,15 +3,38 @@
 
 #include <cctype>           // for std::isalnum
 #include <deque>
+#include <vector>
 #include "util/algo.h"      // for util::none_of
+#include "util/hash.h"
+#include "util/intern.h"
 #include "util/strview.h"
 
 typedef std::string Token;
+// Text of a file read, with a null char after the end.
+// Tokens are null-terminated in place.
+struct Filebuffer
+{
+    char * begin;
+    char * end;
+    Filebuffer() : begin(NULL), end(NULL) {}
+    virtual ~Filebuffer() {}
+};
 // A deque of tokens for input. Tokens are not destroyed after popping.
-struct Tokens : private std::deque<Token>
+// Tokens point into the file buffers, which live as long as the tokens.
+// Equal tokens in the same deque are interned to the same pointer.
+struct Tokens : private std::deque<strview>
 {
     size_type position;
+    // Table of distinct tokens
+    util::Interner symbols;
+    // Hash of the text read into the tokens, in order, before tokenizing
+    util::Hash hash;
     Tokens(): position(0) {}
+    ~Tokens()
+    {
+        for (std::size_t i = 0; i < buffers.size(); ++i)
+            delete buffers[i];
+    }
     using deque::size_type;
     using deque::size;
     using deque::push_back;
@@ -19,6 +42,12 @@ struct Tokens : private std::deque<Token>
     strview front() const { return (*this)[position]; }
     void pop() { ++position; }
     void rewind() { position = 0; }
+    // Take ownership of a file buffer.
+    void addbuffer(Filebuffer * buffer) { buffers.push_back(buffer); }
+private:
+    std::vector<Filebuffer *> buffers;
+    Tokens(Tokens const &);
+    Tokens & operator=(Tokens const &);
 };
 
 // Determine if a char cannot appear in a label ($4.1.1).
@@ -11,6 +11,11 @@
 // Boolean vector
 typedef std::vector<bool> Bvector;
 
+// Code of a symbol, 4 bytes: its ID in the table of tokens read
+typedef unsigned Symbolcode;
+// Codes of the symbols of an expression
+typedef std::vector<Symbolcode> Symbolcodes;
+
 // A constant or a variable with ID and pointer to defining hypothesis
 struct Symbol3;
 // Expression is a sequence of math tokens.
@@ -79,12 +84,20 @@ typedef std::vector<RPNsize> Indentations;
 // Statistics
 typedef RPNsize Weight;
 
+// Instruction of a compiled matcher
+struct Matchop;
+// Compiled matcher, from the root of a template to its leaves
+typedef std::vector<Matchop> Matcher;
+
 struct Hypothesis
 {
     Expression expression;
+    // Codes of the symbols of the expression, empty if not read from a file
+    Symbolcodes codes;
     bool floats;
     RPN  rpn;
     AST  ast;
+    Matcher matcher;
     Hypothesis(Expression const & exp = Expression(), bool floating = false) :
         expression(exp), floats(floating) {}
 };
@@ -226,6 +239,27 @@ inline bool operator==(RPNstep x, RPNstep y)
 inline bool operator<(RPNstep x, RPNstep y)
     { return std::less<const void *>()(x.ptr(), y.ptr()); }
 
+// Instruction of a compiled matcher
+struct Matchop
+{
+    // CTOR: match the syntax axiom. VAR: bind or compare the variable.
+    enum Opcode { FAIL, CTOR, VAR } opcode;
+    union
+    {
+        const void * ptr;
+        Symbol2::ID id;
+    };
+    Matchop(RPNstep step)
+    {
+        if (step.isthm())
+            opcode = CTOR, ptr = step.ptr();
+        else if ((id = step.id()))
+            opcode = VAR;
+        else
+            opcode = FAIL;
+    }
+};
+
 // (Range of steps, begin of subAST)
 struct RPNspanAST: std::pair<RPNspan, ASTiter>
 {
@@ -0,0 +1,42 @@
+#ifndef BITS_H_INCLUDED
+#define BITS_H_INCLUDED
+
+#include <cstddef>  // for std::size_t
+#include <limits>   // for digits
+#include <vector>
+
+namespace util
+{
+// # words of type T needed for n bits
+template<class T> std::size_t nwords(std::size_t n)
+{
+    std::size_t const bits = std::numeric_limits<T>::digits;
+    return (n + bits - 1) / bits;
+}
+
+// Set bit i of a bitmask.
+template<class T> void setbit(std::vector<T> & mask, std::size_t i)
+{
+    std::size_t const bits = std::numeric_limits<T>::digits;
+    mask[i / bits] |= T(1) << (i % bits);
+}
+
+// Return bit i of a bitmask.
+template<class T> bool testbit(std::vector<T> const & mask, std::size_t i)
+{
+    std::size_t const bits = std::numeric_limits<T>::digits;
+    return mask[i / bits] >> (i % bits) & 1;
+}
+
+// Return true if all bits of x are set in y, which is at least as long.
+template<class T>
+bool issubset(std::vector<T> const & x, std::vector<T> const & y)
+{
+    for (typename std::vector<T>::size_type i = 0; i < x.size(); ++i)
+        if (x[i] & ~y[i])
+            return false;
+    return true;
+}
+} // namespace util
+
+#endif // BITS_H_INCLUDED
@@ -0,0 +1,42 @@
+#ifndef HASH_H_INCLUDED
+#define HASH_H_INCLUDED
+
+#include <cstddef>  // for std::size_t
+
+namespace util
+{
+// Incremental FNV-1a hash of a sequence of bytes
+class Hash
+{
+public:
+    Hash() : m_value(is64 ?
+        static_cast<std::size_t>(0xcbf29ce484222325ULL) : 0x811c9dc5) {}
+    // Hash a range of bytes.
+    Hash & add(const char * begin, const char * end)
+    {
+        while (begin != end)
+            addbyte(static_cast<unsigned char>(*begin++));
+        return *this;
+    }
+    // Hash the bytes of a number, one by one,
+    // so that different fields cannot cancel each other out.
+    Hash & add(std::size_t n)
+    {
+        for (std::size_t i = 0; i < sizeof(n); ++i, n >>= 8)
+            addbyte(static_cast<unsigned char>(n));
+        return *this;
+    }
+    std::size_t value() const { return m_value; }
+private:
+    static const bool is64 = sizeof(std::size_t) >= 8;
+    std::size_t m_value;
+    void addbyte(unsigned char c)
+    {
+        static const std::size_t prime = is64 ?
+            static_cast<std::size_t>(0x100000001b3ULL) : 0x01000193;
+        m_value = (m_value ^ c) * prime;
+    }
+};
+} // namespace util
+
+#endif // HASH_H_INCLUDED
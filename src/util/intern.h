@@ -0,0 +1,71 @@
+#ifndef INTERN_H_INCLUDED
+#define INTERN_H_INCLUDED
+
+#include <cstddef>  // for std::size_t
+#include <vector>
+#include "strview.h"
+
+namespace util
+{
+// Table of interned strings, each with a dense ID from 1.
+// Equal strings interned share the same pointer.
+// Strings are not copied and must outlive the table.
+class Interner
+{
+public:
+    typedef unsigned ID;
+    Interner() : m_slots(16), m_strings(1) {}
+    // # IDs, including the null ID 0
+    ID size() const { return static_cast<ID>(m_strings.size()); }
+    // Return the ID of a string, 0 if not interned.
+    ID id(strview str) const { return m_slots[findslot(str)]; }
+    // Intern a string. Return its ID.
+    ID add(strview str)
+    {
+        std::size_t slot = findslot(str);
+        if (m_slots[slot])
+            return m_slots[slot];
+        // Keep the load factor under 1/2.
+        if (2 * m_strings.size() >= m_slots.size())
+        {
+            rehash();
+            slot = findslot(str);
+        }
+        m_strings.push_back(str);
+        return m_slots[slot] = size() - 1;
+    }
+    // Intern a string. Return the shared copy.
+    strview intern(strview str) { return m_strings[add(str)]; }
+private:
+    // Open-addressing hash table: slot -> ID, 0 if empty
+    std::vector<ID> m_slots;
+    // m_strings[id] = string with the ID
+    std::vector<strview> m_strings;
+    // FNV-1a hash of a string
+    static std::size_t hash(const char * s)
+    {
+        std::size_t h = 2166136261u;
+        while (*s)
+            h = (h ^ static_cast<unsigned char>(*s++)) * 16777619u;
+        return h;
+    }
+    // Return the slot holding a string, or the empty slot to put it in.
+    std::size_t findslot(strview str) const
+    {
+        std::size_t const mask = m_slots.size() - 1;
+        std::size_t slot = hash(str.c_str) & mask;
+        while (m_slots[slot] && m_strings[m_slots[slot]] != str)
+            slot = (slot + 1) & mask;
+        return slot;
+    }
+    // Double the # slots.
+    void rehash()
+    {
+        std::vector<ID>(2 * m_slots.size()).swap(m_slots);
+        for (ID id = 1; id < size(); ++id)
+            m_slots[findslot(m_strings[id])] = id;
+    }
+};
+} // namespace util
+
+#endif // INTERN_H_INCLUDED
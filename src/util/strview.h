@@ -19,11 +19,12 @@ struct strview
         return std::memcmp(c_str, prefix.c_str, len) ? NULL : c_str + len;
     }
 };
+// Interned strings compare by pointer first.
 inline bool operator==(strview x, strview y)
-    { return std::strcmp(x.c_str, y.c_str) == 0; }
+    { return x.c_str == y.c_str || std::strcmp(x.c_str, y.c_str) == 0; }
 inline bool operator!=(strview x, strview y)
     { return !(x == y); }
 inline bool operator<(strview x, strview y)
-    { return std::strcmp(x.c_str, y.c_str) < 0; }
+    { return x.c_str != y.c_str && std::strcmp(x.c_str, y.c_str) < 0; }
 
 #endif // STRVIEW_H_INCLUDED
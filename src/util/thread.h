@@ -0,0 +1,73 @@
+#ifndef THREAD_H_INCLUDED
+#define THREAD_H_INCLUDED
+
+#include <cstddef>  // for std::size_t
+#if __cplusplus >= 201103L || defined(_MSC_VER) && _MSC_VER >= 1700
+#define UTIL_THREADS
+#include <atomic>
+#include <functional>   // for std::ref
+#include <thread>
+#include <vector>
+#endif // __cplusplus >= 201103L || defined(_MSC_VER) && _MSC_VER >= 1700
+
+namespace util
+{
+    // # hardware threads, at least 1
+    inline unsigned nthreads()
+    {
+#ifdef UTIL_THREADS
+        unsigned const n = std::thread::hardware_concurrency();
+        return n ? n : 1;
+#else
+        return 1;
+#endif // UTIL_THREADS
+    }
+
+#ifdef UTIL_THREADS
+    // Worker taking indices one by one until none is left
+    template<class F>
+    struct Worker
+    {
+        F & f;
+        std::atomic<std::size_t> & next;
+        std::size_t const n;
+        Worker(F & f, std::atomic<std::size_t> & next, std::size_t n) :
+            f(f), next(next), n(n) {}
+        void operator()() const
+        {
+            for (std::size_t i; (i = next++) < n; )
+                f(i);
+        }
+    };
+#endif // UTIL_THREADS
+
+    // Call f(i) for all i in [0, n) on up to nthreads threads.
+    // Calls with different i must not interfere.
+    // Without thread support, call them in order.
+    template<class F>
+    void parallel_for(std::size_t n, F & f, unsigned nthreads = util::nthreads())
+    {
+#ifdef UTIL_THREADS
+        if (nthreads > n)
+            nthreads = static_cast<unsigned>(n);
+        if (nthreads > 1)
+        {
+            std::atomic<std::size_t> next(0);
+            Worker<F> const worker(f, next, n);
+            std::vector<std::thread> threads;
+            threads.reserve(nthreads - 1);
+            for (unsigned i = 1; i < nthreads; ++i)
+                threads.push_back(std::thread(std::ref(worker)));
+            worker();
+            for (unsigned i = 0; i < threads.size(); ++i)
+                threads[i].join();
+            return;
+        }
+#endif // UTIL_THREADS
+        for (std::size_t i = 0; i < n; ++i)
+            f(i);
+        static_cast<void>(nthreads);
+    }
+} // namespace util
+
+#endif // THREAD_H_INCLUDED
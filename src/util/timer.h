@@ -1,17 +1,32 @@
 #ifndef TIMER_H_INCLUDED
 #define TIMER_H_INCLUDED
 
+#include "thread.h"
+#ifdef UTIL_THREADS
+#include <chrono>
+#else
 #include <ctime>
+#endif // UTIL_THREADS
 
 typedef double Time;
 
+// Wall clock timer, falling back to processor time
 struct Timer
 {
+#ifdef UTIL_THREADS
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point start;
+    void reset() { start = Clock::now(); }
+    Timer() { reset(); }
+    operator Time() const
+    { return std::chrono::duration<Time>(Clock::now() - start).count(); }
+#else
     std::clock_t start;
     void reset() { start = std::clock(); }
     Timer() { reset(); }
     operator Time() const { return resolution() * (std::clock() - start); }
     static Time resolution() { return 1./CLOCKS_PER_SEC; }
+#endif // UTIL_THREADS
 };
 
 #endif // TIMER_H_INCLUDED